@@ -6,8 +6,10 @@
 
 #include <KItinerary/BarcodeDecoder>
 
+#include <QDirIterator>
 #include <QImage>
 #include <QObject>
+#include <QPainter>
 #include <QTest>
 
 Q_DECLARE_METATYPE(KItinerary::BarcodeDecoder::BarcodeType)
@@ -182,6 +184,94 @@ private Q_SLOTS:
         QCOMPARE(decoder.decode(img, BarcodeDecoder::Any).toString(),
                  QLatin1StringView("123456789"));
     }
+
+    void testContentCache()
+    {
+        QImage img(QStringLiteral(SOURCE_DIR "/barcodes/aztec.png"));
+        QVERIFY(!img.isNull());
+        const auto imgCopy = img.copy();
+        QVERIFY(img.cacheKey() != imgCopy.cacheKey());
+
+        BarcodeDecoder decoder;
+        QCOMPARE(decoder.decode(img, BarcodeDecoder::Aztec).toString(), QStringLiteral("This is an example Aztec symbol for Wikipedia."));
+        QCOMPARE(decoder.statistics().fullResolutionAttempts, 1);
+        QCOMPARE(decoder.decode(imgCopy, BarcodeDecoder::Aztec).toString(), QStringLiteral("This is an example Aztec symbol for Wikipedia."));
+        QCOMPARE(decoder.statistics().fullResolutionAttempts, 1);
+
+        img.setPixel(0, 0, 0xffffff);
+        decoder.decode(img, BarcodeDecoder::Aztec);
+        QCOMPARE(decoder.statistics().fullResolutionAttempts, 2);
+    }
+
+    void testMultiLargeImage()
+    {
+        const QImage aztec(QStringLiteral(SOURCE_DIR "/barcodes/aztec.png"));
+        QVERIFY(!aztec.isNull());
+        const QImage code128(QStringLiteral(SOURCE_DIR "/barcodes/code128.png"));
+        QVERIFY(!code128.isNull());
+
+        // a large barcode that survives downscaling next to a small one that doesn't
+        QImage img(1600, 1200, QImage::Format_Grayscale8);
+        img.fill(Qt::white);
+        {
+            QPainter p(&img);
+            p.drawImage(QRect(QPoint(100, 100), aztec.size() * 2), aztec);
+            p.drawImage(QPoint(1000, 900), code128);
+        }
+
+        BarcodeDecoder decoder;
+        const auto results = decoder.decodeMulti(img, BarcodeDecoder::Any);
+        QCOMPARE(results.size(), 2);
+        QStringList contents;
+        for (const auto &res : results) {
+            contents.push_back(res.toString());
+        }
+        contents.sort();
+        QCOMPARE(contents, QStringList({QStringLiteral("123456789"), QStringLiteral("This is an example Aztec symbol for Wikipedia.")}));
+        QCOMPARE(decoder.statistics().downscaledAttempts, 0);
+        QCOMPARE(decoder.statistics().fullResolutionAttempts, 1);
+    }
+
+    void testMultiScale_data()
+    {
+        QTest::addColumn<QString>("fileName");
+
+        QDirIterator it(QStringLiteral(SOURCE_DIR "/barcodes"), {QStringLiteral("*.png")}, QDir::Files);
+        while (it.hasNext()) {
+            it.next();
+            QTest::newRow(qPrintable(it.fileName())) << it.filePath();
+        }
+    }
+
+    void testMultiScale()
+    {
+        QFETCH(QString, fileName);
+        const QImage img(fileName);
+        QVERIFY(!img.isNull());
+        const auto hint = BarcodeDecoder::maybeBarcode(img.width(), img.height(), BarcodeDecoder::Any);
+        if (hint == BarcodeDecoder::None) {
+            QSKIP("not a plausible barcode image");
+        }
+
+        // upscaled versions of the test images must decode the same with multi-scale decoding as without
+        const auto largeImg = img.scaled(img.size() * 4, Qt::IgnoreAspectRatio, Qt::FastTransformation);
+        BarcodeDecoder fullResDecoder;
+        fullResDecoder.setMultiScaleDecodingEnabled(false);
+        const auto fullResResult = fullResDecoder.decode(largeImg, hint);
+        QCOMPARE(fullResDecoder.statistics().downscaledAttempts, 0);
+
+        BarcodeDecoder multiScaleDecoder;
+        const auto multiScaleResult = multiScaleDecoder.decode(largeImg, hint);
+        QCOMPARE(multiScaleResult.contentType, fullResResult.contentType);
+        QCOMPARE(multiScaleResult.content, fullResResult.content);
+
+        const auto stats = multiScaleDecoder.statistics();
+        if (std::max(largeImg.width(), largeImg.height()) >= 1200) {
+            QCOMPARE(stats.downscaledAttempts, 1);
+        }
+        QCOMPARE(stats.downscaledHits + stats.fullResolutionHits, multiScaleResult.contentType == BarcodeDecoder::Result::None ? 0 : 1);
+        QCOMPARE(stats.fullResolutionAttempts, stats.downscaledHits == 1 ? 0 : 1);
+    }
 };
 
 QTEST_APPLESS_MAIN(BarcodeDecoderTest)
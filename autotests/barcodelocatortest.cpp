@@ -0,0 +1,115 @@
+/*
+    SPDX-FileCopyrightText: 2026 KItinerary contributors
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "barcodelocator_p.h"
+
+#include <KItinerary/BarcodeDecoder>
+#include <KItinerary/ExtractorDocumentNode>
+#include <KItinerary/ExtractorDocumentNodeFactory>
+#include <KItinerary/ExtractorDocumentProcessor>
+#include <KItinerary/ExtractorEngine>
+
+#include <QImage>
+#include <QObject>
+#include <QPainter>
+#include <QTest>
+
+#include <algorithm>
+
+using namespace KItinerary;
+
+class BarcodeLocatorTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testEmptyPage()
+    {
+        QVERIFY(BarcodeLocator::findCandidateRegions({}).empty());
+
+        QImage page(1654, 2339, QImage::Format_RGB32);
+        page.fill(Qt::white);
+        bool isComplete = false;
+        QVERIFY(BarcodeLocator::findCandidateRegions(page, &isComplete).empty());
+        QVERIFY(isComplete);
+    }
+
+    void testPageWithBarcode()
+    {
+        const QImage barcode(QStringLiteral(SOURCE_DIR "/barcodes/aztec.png"));
+        QVERIFY(!barcode.isNull());
+
+        // A4 page at 200 dpi, with a horizontal line at the top and a barcode in the lower half
+        QImage page(1654, 2339, QImage::Format_RGB32);
+        page.fill(Qt::white);
+        const QRect barcodeRect(600, 1500, barcode.width(), barcode.height());
+        {
+            QPainter p(&page);
+            p.fillRect(100, 100, 1400, 8, Qt::black);
+            p.drawImage(barcodeRect, barcode);
+        }
+
+        bool isComplete = false;
+        const auto regions = BarcodeLocator::findCandidateRegions(page, &isComplete);
+        QVERIFY(!regions.empty());
+        QVERIFY(isComplete);
+        QVERIFY(regions[0].contains(barcodeRect));
+        QVERIFY(regions[0].width() * regions[0].height() < page.width() * page.height() / 10);
+
+        BarcodeDecoder decoder;
+        const auto results = decoder.decodeMulti(page.copy(regions[0]), BarcodeDecoder::Any | BarcodeDecoder::IgnoreAspectRatio);
+        QCOMPARE(results.size(), 1);
+        QCOMPARE(results[0].toString(), QStringLiteral("This is an example Aztec symbol for Wikipedia."));
+    }
+
+    void testBarcodeOutsideRegions()
+    {
+        const QImage aztec(QStringLiteral(SOURCE_DIR "/barcodes/aztec.png"));
+        QVERIFY(!aztec.isNull());
+
+        // a low contrast 1D barcode, which doesn't look like a barcode to the locator but still decodes fine
+        auto code128 = QImage(QStringLiteral(SOURCE_DIR "/barcodes/code128.png")).convertToFormat(QImage::Format_Grayscale8);
+        QVERIFY(!code128.isNull());
+        code128 = code128.scaled(code128.size() * 3, Qt::IgnoreAspectRatio, Qt::FastTransformation);
+        for (int y = 0; y < code128.height(); ++y) {
+            auto line = code128.scanLine(y);
+            for (int x = 0; x < code128.width(); ++x) {
+                line[x] = line[x] < 128 ? 115 : 145;
+            }
+        }
+
+        QImage page(1654, 2339, QImage::Format_RGB32);
+        page.fill(Qt::white);
+        const QRect aztecRect(600, 1500, aztec.width(), aztec.height());
+        const QRect code128Rect(300, 400, code128.width(), code128.height());
+        {
+            QPainter p(&page);
+            p.drawImage(aztecRect, aztec);
+            p.drawImage(code128Rect, code128);
+        }
+
+        bool isComplete = true;
+        const auto regions = BarcodeLocator::findCandidateRegions(page, &isComplete);
+        QVERIFY(!isComplete);
+        QVERIFY(std::any_of(regions.begin(), regions.end(), [&aztecRect](const auto &r) { return r.contains(aztecRect); }));
+        QVERIFY(std::none_of(regions.begin(), regions.end(), [&code128Rect](const auto &r) { return r.intersects(code128Rect); }));
+
+        // both barcodes are found nevertheless
+        ExtractorEngine engine;
+        engine.setHints(ExtractorEngine::ExtractFullPageRasterImages);
+        auto node = engine.documentNodeFactory()->createNode(page, u"internal/qimage");
+        QVERIFY(!node.isNull());
+        node.processor()->expandNode(node, &engine);
+        QStringList contents;
+        for (const auto &child : node.childNodes()) {
+            contents.push_back(child.content().toString());
+        }
+        contents.sort();
+        QCOMPARE(contents, QStringList({QStringLiteral("123456789"), QStringLiteral("This is an example Aztec symbol for Wikipedia.")}));
+    }
+};
+
+QTEST_GUILESS_MAIN(BarcodeLocatorTest)
+
+#include "barcodelocatortest.moc"
@@ -4,6 +4,7 @@
    SPDX-License-Identifier: LGPL-2.0-or-later
 */
 
+#include "calendareventindex.h"
 #include "calendarhandler.h"
 #include "extractorpostprocessor.h"
 #include "jsonlddocument.h"
@@ -149,6 +150,12 @@ private Q_SLOTS:
         const auto events = CalendarHandler::findEvents(refCal, postproc.result().at(0));
         QCOMPARE(events.size(), 1);
         QVERIFY(events[0]);
+
+        CalendarEventIndex index(refCal.data());
+        for (int i = 0; i < 2; ++i) {
+            QCOMPARE(index.findEvents(postproc.result().at(0)), events);
+        }
+        QCOMPARE(index.reservationsForEvent(events[0]), CalendarHandler::reservationsForEvent(events[0]));
     }
 
     void testFindEventForCancellation()
@@ -167,6 +174,23 @@ private Q_SLOTS:
         QCOMPARE(events.size(), 2);
         QVERIFY(events[0]);
         QVERIFY(events[1]);
+
+        CalendarEventIndex index(refCal.data());
+        auto indexEvents = index.findEvents(cancel);
+        QCOMPARE(indexEvents.size(), 2);
+        QVERIFY(indexEvents.contains(events[0]));
+        QVERIFY(indexEvents.contains(events[1]));
+
+        // changes to the calendar are picked up
+        QVERIFY(refCal->deleteEvent(events[0]));
+        indexEvents = index.findEvents(cancel);
+        QCOMPARE(indexEvents.size(), 1);
+        QCOMPARE(indexEvents[0], events[1]);
+        QVERIFY(refCal->addEvent(events[0]));
+        QCOMPARE(index.findEvents(cancel).size(), 2);
+
+        index.clear();
+        QCOMPARE(index.findEvents(cancel).size(), 2);
     }
 };
 
@@ -11,8 +11,14 @@
 #include <KItinerary/PdfDocument>
 
 #include <QFile>
+#include <QJsonArray>
+#include <QJsonObject>
 #include <QTest>
+#include <QThread>
 
+#include <memory>
+
+using namespace Qt::Literals::StringLiterals;
 using namespace KItinerary;
 
 #define s(x) QStringLiteral(x)
@@ -120,6 +126,212 @@ private Q_SLOTS:
         QCOMPARE(c21.location().toInt(), 1);
     }
 
+    void testNodeArena()
+    {
+        QFile f(QStringLiteral(SOURCE_DIR "/misc/test.pdf"));
+        QVERIFY(f.open(QFile::ReadOnly));
+        const auto data = f.readAll();
+
+        ExtractorEngine refEngine;
+        refEngine.setData(data);
+        const auto refResult = refEngine.extract();
+
+        ExtractorEngine engine;
+        engine.setUseNodeArena(true);
+        for (int i = 0; i < 2; ++i) {
+            engine.clear();
+            engine.setData(data);
+            QCOMPARE(engine.extract(), refResult);
+        }
+
+        // handles outliving the extraction run remain valid
+        auto root = engine.rootDocumentNode();
+        engine.clear();
+        QVERIFY(!root.isNull());
+        QCOMPARE(root.mimeType(), QLatin1StringView("application/pdf"));
+        QCOMPARE(root.childNodes().size(), 5);
+        QCOMPARE(root.childNodes()[2].mimeType(), QLatin1StringView("internal/qimage"));
+        QCOMPARE(root.childNodes()[2].parent(), root);
+        root = {};
+
+        engine.setData(data);
+        QCOMPARE(engine.extract(), refResult);
+    }
+
+    void testStatistics()
+    {
+        QFile f(QStringLiteral(SOURCE_DIR "/misc/test.pdf"));
+        QVERIFY(f.open(QFile::ReadOnly));
+        const auto data = f.readAll();
+
+        ExtractorEngine engine;
+        engine.setData(data);
+        engine.extract();
+        QVERIFY(engine.statistics().empty());
+
+        engine.clear();
+        engine.setCollectStatistics(true);
+        engine.setData(data);
+        engine.extract();
+        const auto stats = engine.statistics();
+        const auto find = [&stats](QLatin1StringView step, QLatin1StringView name) {
+            return std::find_if(stats.begin(), stats.end(), [&](const auto &entry) {
+                return entry.step == step && (name.isEmpty() || entry.name == name);
+            });
+        };
+        QVERIFY(find("createNode"_L1, "application/pdf"_L1) != stats.end());
+        QCOMPARE(find("createNode"_L1, "application/pdf"_L1)->count, 1);
+        QVERIFY(find("expandNode"_L1, "application/pdf"_L1) != stats.end());
+        QVERIFY(find("expandNode"_L1, "internal/qimage"_L1) != stats.end());
+        QVERIFY(find("extract"_L1, "application/pdf"_L1) != stats.end());
+        QVERIFY(find("canHandle"_L1, {}) != stats.end());
+        const auto barcodes = find("decodeBarcode"_L1, {});
+        QVERIFY(barcodes != stats.end());
+        QVERIFY(barcodes->hits > 0);
+        QVERIFY(std::is_sorted(stats.begin(), stats.end(), [](const auto &lhs, const auto &rhs) { return lhs.time > rhs.time; }));
+
+        engine.resetStatistics();
+        QVERIFY(engine.statistics().empty());
+        engine.setCollectStatistics(false);
+        QVERIFY(engine.statistics().empty());
+    }
+
+    void testTrace()
+    {
+        QFile f(QStringLiteral(SOURCE_DIR "/misc/test.pdf"));
+        QVERIFY(f.open(QFile::ReadOnly));
+
+        const auto data = f.readAll();
+
+        ExtractorEngine engine;
+        engine.setRecordTrace(true);
+        engine.setData(data);
+        engine.extract();
+        QVERIFY(engine.statistics().empty());
+
+        const auto events = engine.traceEvents();
+        QVERIFY(!events.isEmpty());
+        bool foundPdfExpansion = false;
+        for (const auto &v : events) {
+            const auto event = v.toObject();
+            QCOMPARE(event.value("ph"_L1).toString(), "X"_L1);
+            QVERIFY(event.value("ts"_L1).toDouble() > 0.0);
+            QVERIFY(event.value("dur"_L1).toDouble() >= 0.0);
+            QVERIFY(event.contains("tid"_L1));
+            foundPdfExpansion |= event.value("name"_L1).toString() == "expandNode application/pdf"_L1;
+        }
+        QVERIFY(foundPdfExpansion);
+
+        engine.resetTrace();
+        QVERIFY(engine.traceEvents().isEmpty());
+        engine.setCollectStatistics(true);
+        engine.setRecordTrace(false);
+        engine.clear();
+        engine.setData(data);
+        engine.extract();
+        QVERIFY(!engine.statistics().empty());
+        QVERIFY(engine.traceEvents().isEmpty());
+    }
+
+    void testMemoryUsage()
+    {
+        QFile f(QStringLiteral(SOURCE_DIR "/misc/test.pdf"));
+        QVERIFY(f.open(QFile::ReadOnly));
+        const auto data = f.readAll();
+
+        ExtractorEngine engine;
+        engine.setData(data);
+        const auto refResult = engine.extract();
+        QVERIFY(!refResult.isEmpty());
+        QVERIFY(engine.memoryUsage(ExtractorEngine::DocumentNodeMemory).current > data.size());
+        QVERIFY(engine.memoryUsage(ExtractorEngine::ImageMemory).current > 0);
+        QVERIFY(engine.memoryUsage(ExtractorEngine::BarcodeCacheMemory).current > 0);
+        QCOMPARE(engine.memoryUsage(ExtractorEngine::ImageMemory).peak, 0);
+
+        engine.clear();
+        engine.setMemoryAccounting(true);
+        engine.setData(data);
+        QCOMPARE(engine.extract(), refResult);
+        for (auto category : {ExtractorEngine::DocumentNodeMemory, ExtractorEngine::ImageMemory, ExtractorEngine::BarcodeCacheMemory}) {
+            const auto usage = engine.memoryUsage(category);
+            QVERIFY(usage.peak > 0);
+            QVERIFY(usage.peak >= usage.current);
+        }
+        // incremental accounting during extraction matches walking the final document tree
+        QCOMPARE(engine.memoryUsage(ExtractorEngine::DocumentNodeMemory).peak, engine.memoryUsage(ExtractorEngine::DocumentNodeMemory).current);
+
+        // soft limits only affect caches and processed nodes, not the result
+        engine.clear();
+        engine.setMemoryAccounting(false);
+        engine.setMemorySoftLimit(ExtractorEngine::ImageMemory, 1);
+        engine.setMemorySoftLimit(ExtractorEngine::PdfImageCacheMemory, 1);
+        engine.setMemorySoftLimit(ExtractorEngine::BarcodeCacheMemory, 1);
+        engine.setData(data);
+        QCOMPARE(engine.extract(), refResult);
+        QVERIFY(engine.memoryUsage(ExtractorEngine::ImageMemory).peak > 0);
+        QCOMPARE(engine.memoryUsage(ExtractorEngine::ImageMemory).current, 0);
+        QCOMPARE(engine.memoryUsage(ExtractorEngine::PdfImageCacheMemory).current, 0);
+        QCOMPARE(engine.memoryUsage(ExtractorEngine::BarcodeCacheMemory).current, 0);
+
+        // document nodes are needed for the result and cannot be limited
+        engine.clear();
+        engine.setMemorySoftLimit(ExtractorEngine::ImageMemory, 0);
+        engine.setMemorySoftLimit(ExtractorEngine::PdfImageCacheMemory, 0);
+        engine.setMemorySoftLimit(ExtractorEngine::BarcodeCacheMemory, 0);
+        QTest::ignoreMessage(QtWarningMsg, "Document node memory cannot be limited, ignoring soft limit 1");
+        engine.setMemorySoftLimit(ExtractorEngine::DocumentNodeMemory, 1);
+        engine.setData(data);
+        QCOMPARE(engine.extract(), refResult);
+        QCOMPARE(engine.memoryUsage(ExtractorEngine::ImageMemory).peak, 0);
+    }
+
+    void testParallelPdf()
+    {
+        std::vector<QByteArray> inputs;
+        for (const auto fileName : {SOURCE_DIR "/misc/test.pdf", SOURCE_DIR "/misc/link.pdf", SOURCE_DIR "/extractordata/synthetic/iata-bcbp-demo.pdf"}) {
+            QFile f(QString::fromUtf8(fileName));
+            QVERIFY(f.open(QFile::ReadOnly));
+            inputs.push_back(f.readAll());
+        }
+
+        std::vector<QJsonArray> refResults;
+        for (const auto &data : inputs) {
+            ExtractorEngine engine;
+            engine.setUseSeparateProcess(false);
+            engine.setData(data);
+            refResults.push_back(engine.extract());
+        }
+
+        // one engine per thread, as in the command line extractor's --jobs mode
+        constexpr int ThreadCount = 4;
+        std::vector<std::vector<QJsonArray>> results(ThreadCount);
+        std::vector<std::unique_ptr<QThread>> threads;
+        for (int i = 0; i < ThreadCount; ++i) {
+            threads.emplace_back(QThread::create([&inputs, &result = results[i]]() {
+                ExtractorEngine engine;
+                engine.setUseSeparateProcess(false);
+                for (int j = 0; j < 3; ++j) {
+                    for (const auto &data : inputs) {
+                        engine.clear();
+                        engine.setData(data);
+                        result.push_back(engine.extract());
+                    }
+                }
+            }));
+            threads.back()->start();
+        }
+        for (const auto &thread : threads) {
+            QVERIFY(thread->wait());
+        }
+
+        for (const auto &result : results) {
+            QCOMPARE(result.size(), inputs.size() * 3);
+            for (std::size_t i = 0; i < result.size(); ++i) {
+                QCOMPARE(result[i], refResults[i % inputs.size()]);
+            }
+        }
+    }
+
     void testPdfExternal()
     {
         ExtractorEngine engine;
@@ -0,0 +1,29 @@
+/*
+    SPDX-FileCopyrightText: 2026 KItinerary contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <KItinerary/ExtractorRepository>
+
+#include <QObject>
+#include <QTest>
+
+using namespace KItinerary;
+
+class ExtractorRepositoryBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkLoad()
+    {
+        ExtractorRepository repo;
+        QBENCHMARK {
+            repo.reload();
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(ExtractorRepositoryBenchmark)
+
+#include "extractorrepositorybenchmark.moc"
@@ -8,10 +8,14 @@
 #include <KItinerary/ExtractorDocumentNode>
 #include <KItinerary/ExtractorDocumentNodeFactory>
 #include <KItinerary/ExtractorEngine>
+#include <KItinerary/ExtractorFilter>
 #include <KItinerary/ExtractorRepository>
 #include <KItinerary/ScriptExtractor>
 
+#include <QJsonArray>
+#include <QJsonObject>
 #include <QObject>
+#include <QRegularExpression>
 #include <QTest>
 
 using namespace KItinerary;
@@ -59,6 +63,41 @@ private Q_SLOTS:
         engine.extractorRepository()->extractorsForNode(root, extractors);
         QCOMPARE(extractors.size(), 0);
     }
+
+    void testFilterPatterns()
+    {
+        // filter patterns are only compiled on first use, so make sure they are all valid here
+        ExtractorRepository repo;
+        for (const auto &extractor : repo.extractors()) {
+            const auto scriptExtractor = dynamic_cast<const ScriptExtractor*>(extractor.get());
+            if (!scriptExtractor) {
+                continue;
+            }
+            QVERIFY(!scriptExtractor->filters().empty());
+            for (const auto &filter : scriptExtractor->filters()) {
+                const QRegularExpression re(filter.pattern());
+                QVERIFY2(re.isValid(), qPrintable(scriptExtractor->name() + QLatin1StringView(": ") + re.errorString()));
+            }
+        }
+    }
+
+    void testCustomFilterPatterns()
+    {
+        QJsonObject filter;
+        filter.insert(QLatin1StringView("mimeType"), QLatin1StringView("text/plain"));
+        filter.insert(QLatin1StringView("match"), QLatin1StringView("(unbalanced"));
+        QJsonObject obj;
+        obj.insert(QLatin1StringView("mimeType"), QLatin1StringView("text/plain"));
+        obj.insert(QLatin1StringView("filter"), QJsonArray({filter}));
+
+        // invalid patterns of custom extractors are rejected right away
+        ScriptExtractor custom;
+        QVERIFY(!custom.load(obj, QStringLiteral("/custom/extractors/invalid.json")));
+
+        // built-in ones are checked by testFilterPatterns() instead
+        ScriptExtractor builtIn;
+        QVERIFY(builtIn.load(obj, QStringLiteral(":/org.kde.pim/kitinerary/extractors/invalid.json")));
+    }
 };
 
 QTEST_GUILESS_MAIN(ExtractorRepositoryTest)
@@ -0,0 +1,164 @@
+/*
+    SPDX-FileCopyrightText: 2026 KItinerary contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "engine/extractorresultcache_p.h"
+
+#include <KItinerary/ExtractorEngine>
+#include <KItinerary/ExtractorRepository>
+
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTest>
+
+using namespace Qt::Literals::StringLiterals;
+using namespace KItinerary;
+
+class ExtractorResultCacheTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase()
+    {
+        qputenv("TZ", "UTC");
+    }
+
+    void testLookup()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        ExtractorResultCache cache(dir.path(), 0);
+        QCOMPARE(cache.size(), 0);
+
+        QJsonArray result;
+        QString usedExtractor;
+        QVERIFY(!cache.lookup("key1", result, usedExtractor));
+
+        QJsonObject obj;
+        obj.insert("@type"_L1, "FlightReservation"_L1);
+        cache.insert("key1", QJsonArray({obj}), u"test-extractor"_s);
+        QVERIFY(cache.size() > 0);
+
+        QVERIFY(cache.lookup("key1", result, usedExtractor));
+        QCOMPARE(result, QJsonArray({obj}));
+        QCOMPARE(usedExtractor, "test-extractor"_L1);
+        QVERIFY(!cache.lookup("key2", result, usedExtractor));
+
+        // persistent across instances
+        ExtractorResultCache cache2(dir.path(), 0);
+        QVERIFY(cache2.lookup("key1", result, usedExtractor));
+        QCOMPARE(result, QJsonArray({obj}));
+        QCOMPARE(cache2.size(), cache.size());
+    }
+
+    void testEviction()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        ExtractorResultCache cache(dir.path(), 1000);
+
+        QJsonObject obj;
+        obj.insert("name"_L1, QString(100, 'x'_L1));
+        for (int i = 0; i < 50; ++i) {
+            cache.insert(QByteArray::number(i), QJsonArray({obj}), {});
+            QVERIFY(cache.size() <= 1000);
+        }
+        const auto entries = QDir(dir.path()).entryList(QDir::Files);
+        QVERIFY(entries.size() < 10);
+        QVERIFY(entries.size() > 1);
+    }
+
+    void testRepositoryFingerprint()
+    {
+        ExtractorRepository repo;
+        const auto fp = ExtractorResultCache::repositoryFingerprint(repo);
+        QVERIFY(!fp.isEmpty());
+        QCOMPARE(ExtractorResultCache::repositoryFingerprint(repo), fp);
+    }
+
+    void testEngine()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        QFile f(QStringLiteral(SOURCE_DIR "/structureddata/foss-events-microdata.html"));
+        QVERIFY(f.open(QFile::ReadOnly));
+        const auto data = f.readAll();
+        const QDateTime contextDt({2026, 1, 1}, {12, 0});
+
+        ExtractorEngine engine;
+        engine.setResultCache(dir.path());
+        engine.setContextDate(contextDt);
+        engine.setData(data, f.fileName());
+        const auto result = engine.extract();
+        QVERIFY(!result.isEmpty());
+        QVERIFY(!engine.rootDocumentNode().isNull());
+        QCOMPARE(QDir(dir.path()).entryList(QDir::Files).size(), 1);
+
+        // cache hit, no document processing
+        engine.clear();
+        engine.setContextDate(contextDt);
+        engine.setData(data, f.fileName());
+        QCOMPARE(engine.extract(), result);
+        QVERIFY(engine.rootDocumentNode().isNull());
+        QCOMPARE(QDir(dir.path()).entryList(QDir::Files).size(), 1);
+
+        // a different time on the same day still hits, as with an implicit "now" context,
+        // with the modification time defaulted from that context updated accordingly
+        {
+            ExtractorEngine uncached;
+            uncached.setContextDate(contextDt.addSecs(3600));
+            uncached.setData(data, f.fileName());
+            const auto laterResult = uncached.extract();
+            QVERIFY(laterResult != result);
+            for (const auto &res : laterResult) {
+                QCOMPARE(res.toObject().value("modifiedTime"_L1).toString(), contextDt.addSecs(3600).toString(Qt::ISODate));
+            }
+
+            ExtractorEngine engine2;
+            engine2.setResultCache(dir.path());
+            engine2.setContextDate(contextDt.addSecs(3600));
+            engine2.setData(data, f.fileName());
+            QCOMPARE(engine2.extract(), laterResult);
+            QVERIFY(engine2.rootDocumentNode().isNull());
+            QCOMPARE(QDir(dir.path()).entryList(QDir::Files).size(), 1);
+        }
+
+        // the same document in a different location hits as well
+        {
+            QTemporaryDir otherDir;
+            QVERIFY(otherDir.isValid());
+            ExtractorEngine engine2;
+            engine2.setResultCache(dir.path());
+            engine2.setContextDate(contextDt);
+            engine2.setData(data, otherDir.filePath(u"foss-events-microdata.html"_s));
+            QCOMPARE(engine2.extract(), result);
+            QVERIFY(engine2.rootDocumentNode().isNull());
+            QCOMPARE(QDir(dir.path()).entryList(QDir::Files).size(), 1);
+        }
+
+        // different context day results in a cache miss
+        engine.clear();
+        engine.setContextDate(contextDt.addDays(1));
+        engine.setData(data, f.fileName());
+        QVERIFY(!engine.extract().isEmpty());
+        QVERIFY(!engine.rootDocumentNode().isNull());
+        QCOMPARE(QDir(dir.path()).entryList(QDir::Files).size(), 2);
+
+        // disabled cache
+        engine.clear();
+        engine.setResultCache({});
+        engine.setContextDate(contextDt);
+        engine.setData(data, f.fileName());
+        QCOMPARE(engine.extract(), result);
+        QVERIFY(!engine.rootDocumentNode().isNull());
+    }
+};
+
+QTEST_GUILESS_MAIN(ExtractorResultCacheTest)
+
+#include "extractorresultcachetest.moc"
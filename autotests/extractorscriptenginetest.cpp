@@ -108,6 +108,31 @@ private Q_SLOTS:
         extractor.setScriptFunction(s("infiniteLoop"));
         const auto result = extractor.extract(root, &engine).jsonLdResult();
     }
+
+    void testRepeatedExecution()
+    {
+        QFile in(s(SOURCE_DIR "/scriptenginedata/plain-text.txt"));
+        QVERIFY(in.open(QFile::ReadOnly | QFile::Text));
+
+        ExtractorEngine engine;
+        auto root = engine.documentNodeFactory()->createNode(in.readAll());
+        QVERIFY(!root.isNull());
+        expandRecursive(root, &engine);
+
+        ScriptExtractor extractor;
+        extractor.setScriptFileName(s(":/reflector.js"));
+        extractor.setScriptFunction(s("dumpArgs"));
+        const auto result = extractor.extract(root, &engine).jsonLdResult();
+        QVERIFY(!result.isEmpty());
+        QCOMPARE(extractor.extract(root, &engine).jsonLdResult(), result);
+
+        // switching scripts in between must load the previous script again
+        ScriptExtractor buggyExtractor;
+        buggyExtractor.setScriptFileName(s(":/buggy.js"));
+        buggyExtractor.setScriptFunction(s("infiniteLoop"));
+        QVERIFY(buggyExtractor.extract(root, &engine).jsonLdResult().isEmpty());
+        QCOMPARE(extractor.extract(root, &engine).jsonLdResult(), result);
+    }
 };
 
 QTEST_GUILESS_MAIN(ExtractorScriptEngineTest)
@@ -11,6 +11,7 @@
 #include <KItinerary/ExtractorValidator>
 #include <KItinerary/JsonLdDocument>
 #include <KItinerary/Reservation>
+#include <KItinerary/ScriptExtractor>
 #include <KItinerary/Ticket>
 
 #include <KMime/Message>
@@ -21,6 +22,7 @@
 #include <QFile>
 #include <QJsonArray>
 #include <QJsonDocument>
+#include <QJsonObject>
 #include <QObject>
 #include <QTest>
 
@@ -199,6 +201,116 @@ private Q_SLOTS:
         }
     }
 
+    void testBudget()
+    {
+        QFile f(QStringLiteral(SOURCE_DIR "/extractordata/synthetic/iata-bcbp-demo.pdf"));
+        QVERIFY(f.open(QFile::ReadOnly));
+        const auto data = f.readAll();
+
+        ExtractorEngine engine;
+        engine.setData(data);
+        const auto fullResult = engine.extract();
+        QVERIFY(!fullResult.isEmpty());
+        QCOMPARE(engine.budgetExhaustion(), ExtractorEngine::BudgetNotExhausted);
+
+        engine.clear();
+        engine.setNodeBudget(1);
+        engine.setData(data);
+        QVERIFY(engine.extract().size() < fullResult.size());
+        QCOMPARE(engine.budgetExhaustion(), ExtractorEngine::NodeBudgetExhausted);
+
+        engine.clear();
+        QCOMPARE(engine.budgetExhaustion(), ExtractorEngine::BudgetNotExhausted);
+        engine.setNodeBudget(0);
+        engine.setData(data);
+        QCOMPARE(engine.extract(), fullResult);
+        QCOMPARE(engine.budgetExhaustion(), ExtractorEngine::BudgetNotExhausted);
+    }
+
+    void testBudgetPartialResult()
+    {
+        // HTML with JSON-LD (cheap, processed first) and a PDF with a barcode (expensive, processed last)
+        QFile f(QStringLiteral(SOURCE_DIR "/extractordata/synthetic/iata-bcbp-demo.pdf"));
+        QVERIFY(f.open(QFile::ReadOnly));
+        const QByteArray data = "From: noreply@non-existing-airline.com\r\n"
+            "Subject: Your Flight Booking\r\n"
+            "Date: Tue, 14 Sep 2021 17:00:00 +0200\r\n"
+            "MIME-Version: 1.0\r\n"
+            "Content-Type: multipart/mixed; boundary=\"budgetTestBoundary\"\r\n"
+            "\r\n"
+            "--budgetTestBoundary\r\n"
+            "Content-Type: text/html; charset=\"us-ascii\"\r\n"
+            "\r\n"
+            "<html><head><script type=\"application/ld+json\">"
+            "{\"@context\": \"http://schema.org\", \"@type\": \"FlightReservation\", \"reservationNumber\": \"RXJ34P\","
+            "\"reservationFor\": {\"@type\": \"Flight\", \"flightNumber\": \"110\", \"airline\": {\"@type\": \"Airline\", \"iataCode\": \"UA\"},"
+            "\"departureAirport\": {\"@type\": \"Airport\", \"iataCode\": \"SFO\"}, \"departureTime\": \"2027-03-04T20:15:00-08:00\","
+            "\"arrivalAirport\": {\"@type\": \"Airport\", \"iataCode\": \"JFK\"}}}"
+            "</script></head><body>Your flight booking.</body></html>\r\n"
+            "--budgetTestBoundary\r\n"
+            "Content-Type: application/pdf; name=\"boarding-pass.pdf\"\r\n"
+            "Content-Transfer-Encoding: base64\r\n"
+            "Content-Disposition: attachment; filename=\"boarding-pass.pdf\"\r\n"
+            "\r\n"
+            + f.readAll().toBase64() + "\r\n"
+            "--budgetTestBoundary--\r\n";
+
+        ExtractorEngine engine;
+        engine.setData(data, u"budget.eml");
+        const auto fullResult = engine.extract();
+        QCOMPARE(engine.budgetExhaustion(), ExtractorEngine::BudgetNotExhausted);
+        QVERIFY(fullResult.size() >= 2);
+
+        const auto hasJsonLdResult = [](const QJsonArray &result) {
+            return std::any_of(result.begin(), result.end(), [](const auto &res) {
+                return res.toObject().value("reservationNumber"_L1).toString() == "RXJ34P"_L1;
+            });
+        };
+        QVERIFY(hasJsonLdResult(fullResult));
+
+        // barcode decoding of the PDF exceeds the pixel budget
+        engine.clear();
+        engine.setPixelBudget(1);
+        engine.setData(data, u"budget.eml");
+        auto result = engine.extract();
+        QCOMPARE(engine.budgetExhaustion(), ExtractorEngine::PixelBudgetExhausted);
+        QVERIFY(result.size() < fullResult.size());
+        QVERIFY(hasJsonLdResult(result));
+        engine.setPixelBudget(0);
+
+        // scripts are interrupted by the watchdog after one second
+        ScriptExtractor slowExtractor;
+        slowExtractor.setScriptFileName(QStringLiteral(SOURCE_DIR "/buggy.js"));
+        slowExtractor.setScriptFunction(QStringLiteral("infiniteLoop"));
+
+        // additional extractors run on every node, so the second node already exceeds the script budget
+        engine.clear();
+        engine.setAdditionalExtractors({&slowExtractor});
+        engine.setScriptBudget(1);
+        engine.setData(data, u"budget.eml");
+        result = engine.extract();
+        QCOMPARE(engine.budgetExhaustion(), ExtractorEngine::ScriptBudgetExhausted);
+        QVERIFY(result.size() < fullResult.size());
+        QVERIFY(hasJsonLdResult(result));
+        engine.setScriptBudget(0);
+
+        // the first script run alone exceeds the time budget
+        engine.clear();
+        engine.setTimeBudget(std::chrono::milliseconds(100));
+        engine.setData(data, u"budget.eml");
+        result = engine.extract();
+        QCOMPARE(engine.budgetExhaustion(), ExtractorEngine::TimeBudgetExhausted);
+        QVERIFY(result.size() < fullResult.size());
+        QVERIFY(hasJsonLdResult(result));
+        engine.setAdditionalExtractors({});
+        engine.setTimeBudget(std::chrono::milliseconds(0));
+
+        engine.clear();
+        engine.setData(data, u"budget.eml");
+        QCOMPARE(engine.extract(), fullResult);
+        QCOMPARE(engine.budgetExhaustion(), ExtractorEngine::BudgetNotExhausted);
+    }
+
     void testNegative()
     {
         m_engine.clear();
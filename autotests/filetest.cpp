@@ -11,12 +11,15 @@
 
 #include <KPkPass/Pass>
 
+#include <KZip>
+
 #include <QByteArray>
 #include <QDebug>
 #include <QFile>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QObject>
+#include <QTemporaryDir>
 #include <QTemporaryFile>
 #include <QTest>
 
@@ -114,6 +117,168 @@ private Q_SLOTS:
         QCOMPARE(in.customData(QStringLiteral("org.kde.kitinerary/UnitTest2"), QStringLiteral("element1")), QByteArray("something else"));
     }
 
+    void testIndex()
+    {
+        QTemporaryFile tmp;
+        QVERIFY(tmp.open());
+        tmp.close();
+
+        {
+            File out(tmp.fileName());
+            QVERIFY(out.open(File::Write));
+            DigitalDocument doc;
+            doc.setName(QStringLiteral("ticket.pdf"));
+            out.addDocument(QStringLiteral("docid1"), doc, QByteArray(4096, 'x'));
+            out.addCustomData(u"org.kde.kitinerary/UnitTest"_s, u"element1"_s, QByteArray("hello world"));
+        }
+
+        // still a regular zip file
+        KZip zip(tmp.fileName());
+        QVERIFY(zip.open(QIODevice::ReadOnly));
+        QVERIFY(zip.directory()->file(u"documents/docid1/ticket.pdf"_s));
+        QVERIFY(zip.directory()->file(u"index.json"_s));
+        zip.close();
+
+        File in(tmp.fileName());
+        QVERIFY(in.open(File::Read));
+        QCOMPARE(in.documents(), QList<QString>({u"docid1"_s}));
+        QCOMPARE(in.documentData(u"docid1"_s), QByteArray(4096, 'x'));
+        QCOMPARE(in.listCustomData(u"org.kde.kitinerary/UnitTest"_s), QList<QString>({u"element1"_s}));
+        QVERIFY(in.hasCustomData(u"org.kde.kitinerary/UnitTest"_s, u"element1"_s));
+        QVERIFY(!in.hasCustomData(u"org.kde.kitinerary/UnitTest"_s, u"element2"_s));
+        QCOMPARE(in.customData(u"org.kde.kitinerary/UnitTest"_s, u"element1"_s), QByteArray("hello world"));
+        QVERIFY(in.customDataFileTime(u"org.kde.kitinerary/UnitTest"_s, u"element1"_s).isValid());
+        QCOMPARE(in.reservations(), QList<QString>());
+        QCOMPARE(in.passes(), QList<QString>());
+    }
+
+    void testNoIndex()
+    {
+        QTemporaryFile tmp;
+        QVERIFY(tmp.open());
+        tmp.close();
+
+        {
+            KZip zip(tmp.fileName());
+            QVERIFY(zip.open(QIODevice::WriteOnly));
+            zip.writeFile(u"custom/org.kde.kitinerary/UnitTest/element1"_s, QByteArray("hello world"));
+        }
+
+        File in(tmp.fileName());
+        QVERIFY(in.open(File::Read));
+        QCOMPARE(in.customData(u"org.kde.kitinerary/UnitTest"_s, u"element1"_s), QByteArray("hello world"));
+    }
+
+    void testIndexMismatch()
+    {
+        QTemporaryFile tmp;
+        QVERIFY(tmp.open());
+        tmp.close();
+
+        {
+            File out(tmp.fileName());
+            QVERIFY(out.open(File::Write));
+            out.addCustomData(u"org.kde.kitinerary/UnitTest"_s, u"element1"_s, QByteArray("hello world"));
+            out.addCustomData(u"org.kde.kitinerary/UnitTest"_s, u"element2"_s, QByteArray("hello again"));
+        }
+
+        // swap the names of both entries in the index only, the archive itself stays intact
+        QFile f(tmp.fileName());
+        QVERIFY(f.open(QFile::ReadWrite));
+        auto data = f.readAll();
+        const auto name1 = QByteArray("\"name\":\"custom/org.kde.kitinerary/UnitTest/element1\"");
+        const auto name2 = QByteArray("\"name\":\"custom/org.kde.kitinerary/UnitTest/element2\"");
+        const auto idx1 = data.indexOf(name1);
+        const auto idx2 = data.indexOf(name2);
+        QVERIFY(idx1 > 0);
+        QVERIFY(idx2 > 0);
+        data.replace(idx1, name1.size(), name2);
+        data.replace(idx2, name2.size(), name1);
+        QVERIFY(f.seek(0));
+        QCOMPARE(f.write(data), data.size());
+        f.close();
+
+        File in(tmp.fileName());
+        QVERIFY(in.open(File::Read));
+        QCOMPARE(in.customData(u"org.kde.kitinerary/UnitTest"_s, u"element1"_s), QByteArray("hello world"));
+        QCOMPARE(in.customData(u"org.kde.kitinerary/UnitTest"_s, u"element2"_s), QByteArray("hello again"));
+        auto customData = in.listCustomData(u"org.kde.kitinerary/UnitTest"_s);
+        std::sort(customData.begin(), customData.end());
+        QCOMPARE(customData, QList<QString>({u"element1"_s, u"element2"_s}));
+    }
+
+    void testAppend()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        const auto fileName = tmp.filePath(u"test.itinerary"_s);
+
+        {
+            File out(fileName);
+            QVERIFY(out.open(File::Append));
+            DigitalDocument doc;
+            doc.setName(QStringLiteral("ticket.pdf"));
+            out.addDocument(QStringLiteral("docid1"), doc, QByteArray("%PDF12345"));
+            out.addCustomData(u"org.kde.kitinerary/UnitTest"_s, u"element1"_s, QByteArray("hello world"));
+        }
+        {
+            File out(fileName);
+            QVERIFY(out.open(File::Append));
+            out.addCustomData(u"org.kde.kitinerary/UnitTest"_s, u"element1"_s, QByteArray("hello again"));
+            out.addCustomData(u"org.kde.kitinerary/UnitTest"_s, u"element2"_s, QByteArray("something else"));
+        }
+
+        File in(fileName);
+        QVERIFY(in.open(File::Read));
+        QCOMPARE(in.documentData(u"docid1"_s), QByteArray("%PDF12345"));
+        auto customData = in.listCustomData(u"org.kde.kitinerary/UnitTest"_s);
+        std::sort(customData.begin(), customData.end());
+        QCOMPARE(customData, QList<QString>({u"element1"_s, u"element2"_s}));
+        QCOMPARE(in.customData(u"org.kde.kitinerary/UnitTest"_s, u"element1"_s), QByteArray("hello again"));
+        QCOMPARE(in.customData(u"org.kde.kitinerary/UnitTest"_s, u"element2"_s), QByteArray("something else"));
+        in.close();
+
+        KZip zip(fileName);
+        QVERIFY(zip.open(QIODevice::ReadOnly));
+        const auto file = zip.directory()->file(u"custom/org.kde.kitinerary/UnitTest/element1"_s);
+        QVERIFY(file);
+        QCOMPARE(file->data(), QByteArray("hello again"));
+    }
+
+    void testCborReservations()
+    {
+        QTemporaryDir tmp;
+        QVERIFY(tmp.isValid());
+        const auto fileName = tmp.filePath(u"test.itinerary"_s);
+
+        QFile resFile(QLatin1StringView(SOURCE_DIR "/pkpassdata/swiss.json"));
+        QVERIFY(resFile.open(QFile::ReadOnly));
+        const auto r = JsonLdDocument::fromJson(QJsonDocument::fromJson(resFile.readAll()).array());
+        QCOMPARE(r.size(), 1);
+
+        {
+            File out(fileName);
+            QVERIFY(out.open(File::Write));
+            out.addReservation(u"json"_s, r.at(0));
+            out.setReservationFormat(File::CborFormat);
+            out.addReservation(u"cbor"_s, r.at(0));
+        }
+
+        File in(fileName);
+        QVERIFY(in.open(File::Read));
+        auto resIds = in.reservations();
+        std::sort(resIds.begin(), resIds.end());
+        QCOMPARE(resIds, QList<QString>({u"cbor"_s, u"json"_s}));
+        QCOMPARE(JsonLdDocument::toJson(in.reservation(u"cbor"_s)), JsonLdDocument::toJson(in.reservation(u"json"_s)));
+        QCOMPARE(JsonLdDocument::toJson(in.reservation(u"cbor"_s)), JsonLdDocument::toJson(r.at(0)));
+        in.close();
+
+        KZip zip(fileName);
+        QVERIFY(zip.open(QIODevice::ReadOnly));
+        QVERIFY(zip.directory()->file(u"reservations/json.json"_s));
+        QVERIFY(zip.directory()->file(u"reservations/cbor.cbor"_s));
+    }
+
     void testMistakes()
     {
         File f;
@@ -0,0 +1,55 @@
+/*
+    SPDX-FileCopyrightText: 2026 KItinerary contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <KItinerary/JsonLdDocument>
+
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QObject>
+#include <QTest>
+
+using namespace KItinerary;
+
+/** Compares JSON and CBOR serialization of JSON-LD data, in speed and size. */
+class JsonLdDocumentBenchmark : public QObject
+{
+    Q_OBJECT
+private:
+    QList<QVariant> m_data;
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        QFile f(QStringLiteral(SOURCE_DIR "/postprocessordata/bcbp-expansion.post.json"));
+        QVERIFY(f.open(QFile::ReadOnly));
+        m_data = JsonLdDocument::fromJson(QJsonDocument::fromJson(f.readAll()).array());
+        QVERIFY(!m_data.isEmpty());
+
+        qDebug() << "JSON size:" << QJsonDocument(JsonLdDocument::toJson(m_data)).toJson(QJsonDocument::Compact).size();
+        qDebug() << "CBOR size:" << JsonLdDocument::toCbor(m_data).size();
+    }
+
+    void benchmarkJsonSerialization()
+    {
+        QBENCHMARK {
+            const auto json = QJsonDocument(JsonLdDocument::toJson(m_data)).toJson(QJsonDocument::Compact);
+            JsonLdDocument::fromJson(QJsonDocument::fromJson(json).array());
+        }
+    }
+
+    void benchmarkCborSerialization()
+    {
+        QBENCHMARK {
+            JsonLdDocument::fromCbor(JsonLdDocument::toCbor(m_data));
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(JsonLdDocumentBenchmark)
+
+#include "jsonlddocumentbenchmark.moc"
@@ -15,6 +15,7 @@
 #include <KItinerary/Brand>
 
 #include <QDebug>
+#include <QDir>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -435,6 +436,40 @@ private Q_SLOTS:
         QCOMPARE(flight.departureTime().timeSpec(), result.timeSpec());
     }
 
+    void testCborRoundtrip_data()
+    {
+        QTest::addColumn<QString>("inFile");
+
+        QDir dir(QStringLiteral(SOURCE_DIR "/postprocessordata"));
+        const auto lst = dir.entryList(QStringList(QStringLiteral("*.post.json")), QDir::Files | QDir::Readable | QDir::NoSymLinks);
+        for (const auto &file : lst) {
+            QTest::newRow(file.toLatin1().constData()) << QString(dir.path() + QLatin1Char('/') + file);
+        }
+    }
+
+    void testCborRoundtrip()
+    {
+        QFETCH(QString, inFile);
+
+        const auto data = JsonLdDocument::fromJson(QJsonDocument::fromJson(readFile(inFile)).array());
+        QVERIFY(!data.isEmpty());
+        const auto cbor = JsonLdDocument::toCbor(data);
+        QVERIFY(!cbor.isEmpty());
+        const auto decoded = JsonLdDocument::fromCbor(cbor);
+        QCOMPARE(decoded.size(), data.size());
+        QCOMPARE(JsonLdDocument::toJson(decoded), JsonLdDocument::toJson(data));
+        QCOMPARE(JsonLdDocument::toCbor(decoded), cbor);
+    }
+
+    void testCborInvalid()
+    {
+        QVERIFY(JsonLdDocument::fromCbor({}).isEmpty());
+        QVERIFY(JsonLdDocument::fromCbor("garbage").isEmpty());
+        QVERIFY(JsonLdDocument::fromCbor(QByteArray::fromHex("83010203")).isEmpty());
+        QVERIFY(!JsonLdDocument::toCbor({}).isEmpty());
+        QVERIFY(JsonLdDocument::fromCbor(JsonLdDocument::toCbor({})).isEmpty());
+    }
+
     void testNormalize_data()
     {
         QTest::addColumn<QString>("inFile");
@@ -441,6 +441,48 @@ private Q_SLOTS:
         QCOMPARE(mergedJson, expected);
     }
 
+    void testFingerprint()
+    {
+        QList<QVariant> elems;
+        QDir dir(QStringLiteral(SOURCE_DIR "/mergedata"));
+        const auto lst = dir.entryList(QStringList(QStringLiteral("*.json")), QDir::Files | QDir::Readable | QDir::NoSymLinks);
+        for (const auto &file : lst) {
+            const auto data = JsonLdDocument::fromJson(QJsonDocument::fromJson(readFile(dir.path() + '/'_L1 + file)).array());
+            for (const auto &elem : data) {
+                elems.push_back(elem);
+                const auto resFor = JsonLdDocument::readProperty(elem, "reservationFor");
+                if (!resFor.isNull()) {
+                    elems.push_back(resFor);
+                }
+            }
+        }
+        QVERIFY(elems.size() > 30);
+
+        // fast rejection must never change the result of isSame()
+        int rejected = 0;
+        for (const auto &lhs : elems) {
+            const auto lhsFp = MergeUtil::fingerprint(lhs);
+            for (const auto &rhs : elems) {
+                const auto rhsFp = MergeUtil::fingerprint(rhs);
+                QCOMPARE(MergeUtil::mayBeSame(lhsFp, rhsFp), MergeUtil::mayBeSame(rhsFp, lhsFp));
+                if (!MergeUtil::mayBeSame(lhsFp, rhsFp)) {
+                    QVERIFY(!MergeUtil::isSame(lhs, rhs));
+                    ++rejected;
+                }
+            }
+        }
+        QVERIFY(rejected > 0);
+
+        FlightReservation res1;
+        res1.setReservationNumber(u"XXX007"_s);
+        FlightReservation res2;
+        res2.setReservationNumber(u"YYY008"_s);
+        QVERIFY(!MergeUtil::mayBeSame(MergeUtil::fingerprint(res1), MergeUtil::fingerprint(res2)));
+        QVERIFY(!MergeUtil::mayBeSame(MergeUtil::fingerprint(res1), MergeUtil::fingerprint(TrainReservation())));
+        res2.setReservationNumber({});
+        QVERIFY(MergeUtil::mayBeSame(MergeUtil::fingerprint(res1), MergeUtil::fingerprint(res2)));
+    }
+
     void testIsSameIncidence()
     {
       const auto lhsFlight =
@@ -0,0 +1,42 @@
+/*
+    SPDX-FileCopyrightText: 2026 KItinerary contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <KItinerary/PdfDocument>
+
+#include <QFile>
+#include <QImage>
+#include <QObject>
+#include <QTest>
+
+using namespace KItinerary;
+
+class PdfDocumentBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkImageLoading()
+    {
+        QFile f(QStringLiteral(SOURCE_DIR "/misc/test.pdf"));
+        QVERIFY(f.open(QFile::ReadOnly));
+        const auto data = f.readAll();
+
+        QBENCHMARK {
+            // decoded image data is cached per document
+            std::unique_ptr<PdfDocument> doc(PdfDocument::fromData(data));
+            QVERIFY(doc);
+            for (int i = 0; i < doc->pageCount(); ++i) {
+                const auto page = doc->page(i);
+                for (int j = 0; j < page.imageCount(); ++j) {
+                    QVERIFY(!page.image(j).image().isNull());
+                }
+            }
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(PdfDocumentBenchmark)
+
+#include "pdfdocumentbenchmark.moc"
@@ -4,6 +4,7 @@
     SPDX-License-Identifier: LGPL-2.0-or-later
 */
 
+#include <KItinerary/BarcodeDecoder>
 #include <KItinerary/PdfDocument>
 #include <KItinerary/PdfLink>
 
@@ -105,6 +106,41 @@ private Q_SLOTS:
         QCOMPARE(page.linksInRect(0.0, 0.5, 1.0, 1.0).size(), 0);
     }
 
+    void testVectorBarcode()
+    {
+        QFile f(QStringLiteral(SOURCE_DIR "/misc/vector-barcode.pdf"));
+        QVERIFY(f.open(QFile::ReadOnly));
+        std::unique_ptr<PdfDocument> doc(PdfDocument::fromData(f.readAll()));
+        QVERIFY(doc);
+        QCOMPARE(doc->pageCount(), 2);
+
+        const auto expected = QLatin1StringView("This is an example Aztec symbol for Wikipedia.");
+        BarcodeDecoder decoder;
+
+        // filled rectangles in two overlapping even-odd paths, rendered from the module grid
+        auto page = doc->page(0);
+        QCOMPARE(page.imageCount(), 1);
+        auto img = page.image(0);
+        QVERIFY(img.isVectorImage());
+        const auto gridImg = img.image();
+        QCOMPARE(gridImg.width(), (23 + 8) * 3);
+        QCOMPARE(gridImg.height(), (23 + 8) * 3);
+        QCOMPARE(decoder.decode(gridImg, BarcodeDecoder::Aztec).toString(), expected);
+
+        img.setLoadingHints(PdfImage::RenderVectorPathsHint);
+        const auto pathImg = img.image();
+        QVERIFY(pathImg.cacheKey() != gridImg.cacheKey());
+        QCOMPARE(decoder.decode(pathImg, BarcodeDecoder::Aztec).toString(), expected);
+
+        // modules made of triangles, which have to be painted
+        page = doc->page(1);
+        QCOMPARE(page.imageCount(), 1);
+        img = page.image(0);
+        QVERIFY(img.isVectorImage());
+        QVERIFY(img.image().width() != (23 + 8) * 3);
+        QCOMPARE(decoder.decode(img.image(), BarcodeDecoder::Aztec).toString(), expected);
+    }
+
     void testInvalidPdfDocument()
     {
         QVERIFY(!PdfDocument::maybePdf(QByteArray()));
@@ -28,9 +28,14 @@ private Q_SLOTS:
     {
         const QByteArray input("06DNQL4XHVK00TTRCGPUQWNTHPGHWBPOUTKRWXAJKGHFBAPBCTOGUZQVTZTKKDEBQXPGRWZJRJBXJZPOHNJGIPDJWEGYWJXLVPGEEZBCUUELIJMOINPRZMSDQCZJGLIZLUTQHXMTPKWCMJISUXQLORAOVYXSOLGXXGMVUDXTMHAYMBLUTKPUPFCRNNTDBBDLNWSBPDUXYKSIMJSBYBURSCPUMFBZPEUTECHTIOXAH");
 
-        const auto output = Rsp6Decoder::decode(input);
+        const auto expected = QByteArray::fromHex("0092ec6c538a36ad00c30c39c99a6c24826ca0828c2ec800c07d128a00000000000000000000000000000000000000018251466a000a530b800000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000007737378f24651de7");
+        auto output = Rsp6Decoder::decode(input);
         QVERIFY(!output.isEmpty());
-        QCOMPARE(output, QByteArray::fromHex("0092ec6c538a36ad00c30c39c99a6c24826ca0828c2ec800c07d128a00000000000000000000000000000000000000018251466a000a530b800000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000007737378f24651de7"));
+        QCOMPARE(output, expected);
+
+        // second run uses the cached keys and the previously successful key/padding combination
+        output = Rsp6Decoder::decode(input);
+        QCOMPARE(output, expected);
     }
 };
 
@@ -37,6 +37,29 @@ private Q_SLOTS:
         QCOMPARE(StringUtil::normalize(in), out);
     }
 
+    void testNormalizeLatinTable()
+    {
+        // the lookup table fast path must produce the same result as the generic code
+        for (char16_t c = 1; c < 0xD800; ++c) {
+            QString ref;
+            normalizeChar(QChar(c), ref);
+            QCOMPARE(StringUtil::normalize(QStringView(&c, 1)), ref);
+        }
+        QCOMPARE(StringUtil::normalize(u"Zürich Flughafen Œuvre ŁÓDŹ ﬁ"), QStringLiteral("zurich flughafen œuvre łodz fi"));
+    }
+
+    void testMemoized()
+    {
+        for (int i = 0; i < 2; ++i) {
+            QCOMPARE(StringUtil::normalizeMemoized(_("NöRMÄl")), _("normal"));
+            QCOMPARE(StringUtil::transliterateMemoized(_("Köln")), _("Koeln"));
+        }
+        for (int i = 0; i < 1000; ++i) {
+            QCOMPARE(StringUtil::normalizeMemoized(QString::number(i)), QString::number(i));
+        }
+        QCOMPARE(StringUtil::normalizeMemoized(QString()), QString());
+    }
+
     void testPrefixSimilarity()
     {
         QCOMPARE(StringUtil::prefixSimilarity(QString(), QString()), 0.0f);
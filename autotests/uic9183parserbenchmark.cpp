@@ -0,0 +1,57 @@
+/*
+    SPDX-FileCopyrightText: 2026 KItinerary contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <KItinerary/Uic9183Parser>
+
+#include <QDir>
+#include <QFile>
+#include <QObject>
+#include <QTest>
+
+using namespace KItinerary;
+
+class Uic9183ParserBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkDecode_data()
+    {
+        QTest::addColumn<QString>("inFile");
+
+        QDir dir(QStringLiteral(SOURCE_DIR "/uic918-3/valid"));
+        const auto lst = dir.entryList(QStringList(QStringLiteral("*.bin")), QDir::Files | QDir::Readable | QDir::NoSymLinks);
+        for (const auto &file : lst) {
+            QTest::newRow(file.toUtf8().constData()) << QString(dir.path() + QLatin1Char('/') +  file);
+        }
+    }
+
+    void benchmarkDecode()
+    {
+        QFETCH(QString, inFile);
+        QFile f(inFile);
+        QVERIFY(f.open(QFile::ReadOnly));
+        const auto data = f.readAll();
+
+        QBENCHMARK {
+            Uic9183Parser p;
+            p.parse(data);
+            p.pnr();
+            p.name();
+            p.validFrom();
+            p.validUntil();
+            p.person();
+            p.outboundDepartureStation();
+            p.outboundArrivalStation();
+            p.returnDepartureStation();
+            p.returnArrivalStation();
+            p.seatingType();
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(Uic9183ParserBenchmark)
+
+#include "uic9183parserbenchmark.moc"
@@ -0,0 +1,41 @@
+/*
+    SPDX-FileCopyrightText: 2026 KItinerary contributors
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "asn1/uperdecoder.h"
+#include <asn1/uperdecoder.cpp>
+#include <asn1/bitvectorview.cpp>
+
+#include <QObject>
+#include <QTest>
+
+using namespace KItinerary;
+
+class UPERDecoderBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkDecode()
+    {
+        const auto data = QByteArray::fromHex("723004D580D1845E168AEAE4C2D2D840845CAC5C500550E8");
+        QBENCHMARK {
+            UPERDecoder d(BitVectorView(std::string_view(data.constData(), data.size())));
+            d.readBoolean();
+            d.readBitset<4>();
+            d.readBoolean();
+            d.readBitset<14>();
+            d.readConstrainedWholeNumber(1, 32000);
+            d.readConstrainedWholeNumber(2016, 2269);
+            d.readConstrainedWholeNumber(1, 366);
+            d.readConstrainedWholeNumber(0, 1440);
+            d.readUtf8String();
+            d.seek(13);
+            d.readIA5String(8, 8);
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(UPERDecoderBenchmark)
+
+#include "uperdecoderbenchmark.moc"
@@ -47,6 +47,23 @@ private Q_SLOTS:
         d.seek(13);
         QCOMPARE(d.readIA5String(4, 4), "1187");
     }
+
+    void testUnalignedStrings()
+    {
+        // "Eurail B.V." UTF-8 string from above, at odd bit offsets
+        const auto data = QByteArray::fromHex("723004D580D1845E168AEAE4C2D2D840845CAC5C500550E8");
+        BitVectorView view(std::string_view(data.constData(), data.size()));
+        QCOMPARE(view.byteArrayAt(71, 11), "Eurail B.V.");
+        QCOMPARE(view.byteArrayAt(64, 4), QByteArray::fromHex("168AEAE4"));
+        QCOMPARE(view.byteArrayAt(184, 4), QByteArray::fromHex("E8000000"));
+
+        // IA5 string runs longer than a single 64 bit word
+        const auto ia5 = QByteArray::fromHex("B85C3870E1C3870E1C3870E1C3870E1C38F0");
+        UPERDecoder d(BitVectorView(std::string_view(ia5.constData(), ia5.size())));
+        d.seek(3);
+        QCOMPARE(d.readIA5String(20, 20), "a888888888888888888x");
+        QCOMPARE(d.offset(), 143);
+    }
 };
 
 QTEST_APPLESS_MAIN(UPERDecoderTest)
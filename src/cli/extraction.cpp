@@ -0,0 +1,218 @@
+/*
+    SPDX-FileCopyrightText: 2026 KItinerary contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "extraction.h"
+
+#include <KItinerary/ExtractorEngine>
+#include <KItinerary/ExtractorPostprocessor>
+#include <KItinerary/ExtractorRepository>
+#include <KItinerary/ExtractorValidator>
+#include <KItinerary/JsonLdDocument>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+using namespace Qt::Literals::StringLiterals;
+using namespace KItinerary;
+
+// engine trace tracks are numbered sequentially per thread, keep ours clearly separate
+constexpr inline int TraceTrackOffset = 1 << 16;
+
+ExtractionTrace::ExtractionTrace(int track, const QString &trackName)
+    : m_track(TraceTrackOffset + track)
+{
+    QJsonObject event;
+    event.insert("name"_L1, "thread_name"_L1);
+    event.insert("ph"_L1, "M"_L1);
+    event.insert("pid"_L1, QCoreApplication::applicationPid());
+    event.insert("tid"_L1, m_track);
+    event.insert("args"_L1, QJsonObject({{"name"_L1, trackName}}));
+    events.push_back(event);
+}
+
+void ExtractionTrace::record(QLatin1StringView name, std::chrono::steady_clock::time_point start, const QString &detail)
+{
+    const auto end = std::chrono::steady_clock::now();
+    QJsonObject event;
+    QString label = name;
+    if (!detail.isEmpty()) {
+        label += u' ';
+        label += detail;
+    }
+    event.insert("name"_L1, label);
+    event.insert("cat"_L1, name);
+    event.insert("ph"_L1, "X"_L1);
+    event.insert("ts"_L1, std::chrono::duration<double, std::micro>(start.time_since_epoch()).count());
+    event.insert("dur"_L1, std::chrono::duration<double, std::micro>(end - start).count());
+    event.insert("pid"_L1, QCoreApplication::applicationPid());
+    event.insert("tid"_L1, m_track);
+    events.push_back(event);
+}
+
+void setupEngine(ExtractorEngine &engine, const ExtractionOptions &opts)
+{
+    engine.setUseSeparateProcess(false); // we are the external extractor
+    engine.setCollectStatistics(opts.statistics);
+    engine.setRecordTrace(opts.trace);
+    if (!opts.cacheDir.isEmpty()) {
+        engine.setResultCache(opts.cacheDir, opts.cacheSize);
+    }
+    setupAdditionalExtractors(engine, opts);
+}
+
+void setupAdditionalExtractors(ExtractorEngine &engine, const ExtractionOptions &opts)
+{
+    std::vector<const AbstractExtractor*> exts;
+    exts.reserve(opts.extractors.size());
+    const ExtractorRepository repo;
+    for (const auto &name : opts.extractors) {
+        const auto ext = repo.extractorByName(name);
+        exts.push_back(ext);
+    }
+    engine.setAdditionalExtractors(std::move(exts));
+}
+
+ExtractionInput readInput(const QString &arg)
+{
+    ExtractionInput input;
+    QFile f;
+    if (!arg.isEmpty()) {
+        f.setFileName(arg);
+        if (!f.open(QFile::ReadOnly)) {
+            input.fileName = arg;
+            input.error = f.errorString();
+            return input;
+        }
+    } else {
+        f.open(stdin, QFile::ReadOnly);
+    }
+    input.fileName = f.fileName();
+    input.data = f.readAll();
+    return input;
+}
+
+ExtractionResult extract(ExtractorEngine &engine, const ExtractionInput &input, const ExtractionOptions &opts)
+{
+    ExtractionResult res;
+    res.fileName = input.fileName;
+    if (!input.error.isEmpty()) {
+        res.error = input.error;
+        return res;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    engine.clear();
+    engine.setContextDate(opts.contextDate);
+    engine.setData(input.data, input.fileName, input.mimeType);
+    res.result = engine.extract();
+    res.elapsed = timer.elapsed();
+    return res;
+}
+
+[[nodiscard]] static QList<QVariant> validatedResult(const ExtractorPostprocessor &postproc, const ExtractionOptions &opts, ExtractionTrace *trace)
+{
+    auto result = postproc.result();
+    if (opts.validate) {
+        const auto start = std::chrono::steady_clock::now();
+        ExtractorValidator validator;
+        result.erase(std::remove_if(result.begin(), result.end(), [&validator](const auto &elem) {
+            return !validator.isValidElement(elem);
+        }), result.end());
+        if (trace) {
+            trace->record("validate"_L1, start);
+        }
+    }
+    return result;
+}
+
+QList<QVariant> postprocess(const std::vector<ExtractionResult> &results, const ExtractionOptions &opts, ExtractionTrace *trace)
+{
+    ExtractorPostprocessor postproc;
+    postproc.setContextDate(opts.contextDate);
+    for (const auto &res : results) {
+        const auto start = std::chrono::steady_clock::now();
+        postproc.process(JsonLdDocument::fromJson(res.result));
+        if (trace) {
+            trace->record("postprocess"_L1, start, res.fileName);
+        }
+    }
+    return validatedResult(postproc, opts, trace);
+}
+
+void mergeStatistics(std::vector<ExtractorEngine::StatisticsEntry> &stats, const std::vector<ExtractorEngine::StatisticsEntry> &entries)
+{
+    for (const auto &entry : entries) {
+        const auto it = std::find_if(stats.begin(), stats.end(), [&entry](const auto &e) {
+            return e.step == entry.step && e.name == entry.name;
+        });
+        if (it == stats.end()) {
+            stats.push_back(entry);
+        } else {
+            (*it).count += entry.count;
+            (*it).hits += entry.hits;
+            (*it).time += entry.time;
+        }
+    }
+}
+
+void printStatistics(std::vector<ExtractorEngine::StatisticsEntry> stats)
+{
+    std::sort(stats.begin(), stats.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.time > rhs.time;
+    });
+    std::cerr << "time [ms]  count   hits  step           name" << std::endl;
+    for (const auto &entry : stats) {
+        std::cerr << std::setw(9) << std::fixed << std::setprecision(2) << (entry.time.count() / 1000000.0)
+                  << std::setw(7) << entry.count << std::setw(7) << entry.hits
+                  << "  " << std::left << std::setw(15) << qPrintable(entry.step) << std::right
+                  << qPrintable(entry.name) << std::endl;
+    }
+}
+
+QJsonObject toNdJson(const ExtractionResult &res, const ExtractionOptions &opts, ExtractionTrace *trace)
+{
+    QJsonObject obj;
+    obj.insert(QLatin1StringView("file"), res.fileName);
+    if (!res.error.isEmpty()) {
+        obj.insert(QLatin1StringView("error"), res.error);
+        return obj;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const auto start = std::chrono::steady_clock::now();
+    ExtractorPostprocessor postproc;
+    postproc.setContextDate(opts.contextDate);
+    postproc.process(JsonLdDocument::fromJson(res.result));
+    if (trace) {
+        trace->record("postprocess"_L1, start, res.fileName);
+    }
+    obj.insert(QLatin1StringView("result"), JsonLdDocument::toJson(validatedResult(postproc, opts, trace)));
+    obj.insert(QLatin1StringView("elapsedMs"), res.elapsed + timer.elapsed());
+    return obj;
+}
+
+bool writeTrace(const QString &fileName, const QJsonArray &events)
+{
+    QFile f(fileName);
+    if (!f.open(QFile::WriteOnly | QFile::Truncate)) {
+        std::cerr << qPrintable(f.errorString()) << std::endl;
+        return false;
+    }
+    QJsonObject trace;
+    trace.insert("traceEvents"_L1, events);
+    trace.insert("displayTimeUnit"_L1, "ms"_L1);
+    f.write(QJsonDocument(trace).toJson(QJsonDocument::Compact));
+    return true;
+}
@@ -0,0 +1,94 @@
+/*
+    SPDX-FileCopyrightText: 2026 KItinerary contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KITINERARY_CLI_EXTRACTION_H
+#define KITINERARY_CLI_EXTRACTION_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QLatin1StringView>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+
+#include <KItinerary/ExtractorEngine>
+
+#include <chrono>
+#include <vector>
+
+class QJsonObject;
+
+/** Options applying to all inputs of one extractor invocation. */
+struct ExtractionOptions {
+    QDateTime contextDate;
+    QStringList extractors;
+    QString cacheDir;
+    qint64 cacheSize = 64 * 1024 * 1024;
+    bool validate = true;
+    bool statistics = false;
+    bool trace = false;
+};
+
+/** Trace events for the work done by the extractor tool itself,
+ *  on a separate track next to those of the engine.
+ */
+class ExtractionTrace
+{
+public:
+    explicit ExtractionTrace(int track, const QString &trackName);
+    /** Records a complete event from @p start until now. */
+    void record(QLatin1StringView name, std::chrono::steady_clock::time_point start, const QString &detail = {});
+
+    QJsonArray events;
+
+private:
+    int m_track;
+};
+
+/** A single input document. */
+struct ExtractionInput {
+    QString fileName;
+    QString mimeType;
+    QByteArray data;
+    QString error;
+};
+
+/** Extraction result for a single input document, before post-processing. */
+struct ExtractionResult {
+    QString fileName;
+    QJsonArray result;
+    QString error;
+    qint64 elapsed = 0;
+};
+
+/** Applies engine-wide settings from @p opts. */
+void setupEngine(KItinerary::ExtractorEngine &engine, const ExtractionOptions &opts);
+/** Applies the additional extractors from @p opts. */
+void setupAdditionalExtractors(KItinerary::ExtractorEngine &engine, const ExtractionOptions &opts);
+
+/** Reads the input file @p arg, or stdin if that is empty. */
+[[nodiscard]] ExtractionInput readInput(const QString &arg);
+
+/** Runs the extraction on a single input document. */
+[[nodiscard]] ExtractionResult extract(KItinerary::ExtractorEngine &engine, const ExtractionInput &input, const ExtractionOptions &opts);
+
+/** Post-processes and validates the results of all inputs together. */
+[[nodiscard]] QList<QVariant> postprocess(const std::vector<ExtractionResult> &results, const ExtractionOptions &opts, ExtractionTrace *trace = nullptr);
+
+/** Adds the statistics @p entries of one engine to @p stats. */
+void mergeStatistics(std::vector<KItinerary::ExtractorEngine::StatisticsEntry> &stats, const std::vector<KItinerary::ExtractorEngine::StatisticsEntry> &entries);
+/** Prints the statistics @p stats to stderr. */
+void printStatistics(std::vector<KItinerary::ExtractorEngine::StatisticsEntry> stats);
+
+/** One line of NDJSON output, each input is post-processed on its own here. */
+[[nodiscard]] QJsonObject toNdJson(const ExtractionResult &res, const ExtractionOptions &opts, ExtractionTrace *trace = nullptr);
+
+/** Writes @p events to @p fileName in Chrome trace event format. */
+bool writeTrace(const QString &fileName, const QJsonArray &events);
+
+#endif // KITINERARY_CLI_EXTRACTION_H
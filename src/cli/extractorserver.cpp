@@ -0,0 +1,194 @@
+/*
+    SPDX-FileCopyrightText: 2026 KItinerary contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "extractorserver.h"
+
+#include <KItinerary/ExtractorEngine>
+#include <KItinerary/JsonLdDocument>
+
+#include <QCborArray>
+#include <QCborValue>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QtEndian>
+
+#include <iostream>
+#include <memory>
+
+using namespace Qt::Literals::StringLiterals;
+using namespace KItinerary;
+
+constexpr inline quint32 MaxFrameSize = 256 * 1024 * 1024;
+constexpr inline int ConnectTimeout = 1000; // ms
+constexpr inline int ResponseTimeout = 300000; // ms
+
+static void writeFrame(QLocalSocket *socket, const QCborMap &msg)
+{
+    const auto payload = msg.toCborValue().toCbor();
+    char header[sizeof(quint32)];
+    qToBigEndian<quint32>(payload.size(), header);
+    socket->write(header, sizeof(header));
+    socket->write(payload);
+}
+
+// returns @c true once @p buffer contains a complete frame, which is then consumed
+[[nodiscard]] static bool readFrame(QByteArray &buffer, QCborMap &msg, bool &error)
+{
+    if (buffer.size() < (qsizetype)sizeof(quint32)) {
+        return false;
+    }
+    const auto size = qFromBigEndian<quint32>(buffer.constData());
+    if (size > MaxFrameSize) {
+        error = true;
+        return false;
+    }
+    if (buffer.size() < (qsizetype)(sizeof(quint32) + size)) {
+        return false;
+    }
+    msg = QCborValue::fromCbor(buffer.mid(sizeof(quint32), size)).toMap();
+    buffer.remove(0, sizeof(quint32) + size);
+    return true;
+}
+
+[[nodiscard]] static QCborMap encodeRequest(const std::vector<ExtractionInput> &inputs, const ExtractionOptions &opts, bool ndjson)
+{
+    QCborArray cborInputs;
+    for (const auto &input : inputs) {
+        QCborMap cborInput;
+        cborInput.insert("fileName"_L1, input.fileName);
+        if (!input.mimeType.isEmpty()) {
+            cborInput.insert("mimeType"_L1, input.mimeType);
+        }
+        if (!input.error.isEmpty()) {
+            cborInput.insert("error"_L1, input.error);
+        }
+        cborInput.insert("data"_L1, input.data);
+        cborInputs.push_back(cborInput);
+    }
+
+    QCborMap req;
+    req.insert("inputs"_L1, cborInputs);
+    req.insert("contextDate"_L1, opts.contextDate.toString(Qt::ISODateWithMs));
+    req.insert("extractors"_L1, QCborArray::fromStringList(opts.extractors));
+    req.insert("validate"_L1, opts.validate);
+    req.insert("ndjson"_L1, ndjson);
+    return req;
+}
+
+[[nodiscard]] static QCborMap handleRequest(ExtractorEngine &engine, const QCborMap &req, ExtractionOptions opts)
+{
+    opts.contextDate = QDateTime::fromString(req.value("contextDate"_L1).toString(), Qt::ISODateWithMs);
+    if (!opts.contextDate.isValid()) {
+        opts.contextDate = QDateTime::currentDateTime();
+    }
+    opts.extractors.clear();
+    for (const auto &ext : req.value("extractors"_L1).toArray()) {
+        opts.extractors.push_back(ext.toString());
+    }
+    opts.validate = req.value("validate"_L1).toBool(true);
+    setupAdditionalExtractors(engine, opts);
+
+    const auto ndjson = req.value("ndjson"_L1).toBool();
+    std::vector<ExtractionResult> results;
+    QCborArray lines;
+    QCborMap resp;
+    for (const auto &cborInput : req.value("inputs"_L1).toArray()) {
+        const auto map = cborInput.toMap();
+        ExtractionInput input;
+        input.fileName = map.value("fileName"_L1).toString();
+        input.mimeType = map.value("mimeType"_L1).toString();
+        input.data = map.value("data"_L1).toByteArray();
+        input.error = map.value("error"_L1).toString();
+
+        auto res = extract(engine, input, opts);
+        if (ndjson) {
+            lines.push_back(QCborMap::fromJsonObject(toNdJson(res, opts)));
+        } else if (!res.error.isEmpty()) {
+            resp.insert("error"_L1, res.error);
+            return resp;
+        } else {
+            results.push_back(std::move(res));
+        }
+    }
+
+    if (ndjson) {
+        resp.insert("lines"_L1, lines);
+    } else {
+        resp.insert("result"_L1, QCborArray::fromJsonArray(JsonLdDocument::toJson(postprocess(results, opts))));
+    }
+    return resp;
+}
+
+int ExtractorServer::serve(const QString &socketName, const ExtractionOptions &opts)
+{
+    {
+        QLocalSocket probe;
+        probe.connectToServer(socketName);
+        if (probe.waitForConnected(ConnectTimeout)) {
+            std::cerr << "Extractor server already running at " << qPrintable(socketName) << std::endl;
+            return 1;
+        }
+    }
+    // nobody is listening, so this can only be a stale socket from a previous instance
+    QLocalServer::removeServer(socketName);
+
+    QLocalServer server;
+    server.setSocketOptions(QLocalServer::UserAccessOption);
+    if (!server.listen(socketName)) {
+        std::cerr << qPrintable(server.errorString()) << std::endl;
+        return 1;
+    }
+
+    // kept alive across requests, so startup costs are only paid once
+    ExtractorEngine engine;
+    setupEngine(engine, opts);
+
+    QObject::connect(&server, &QLocalServer::newConnection, &server, [&server, &engine, &opts]() {
+        while (auto socket = server.nextPendingConnection()) {
+            auto buffer = std::make_shared<QByteArray>();
+            QObject::connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+            QObject::connect(socket, &QLocalSocket::readyRead, socket, [socket, buffer, &engine, &opts]() {
+                buffer->append(socket->readAll());
+                QCborMap req;
+                bool error = false;
+                while (readFrame(*buffer, req, error)) {
+                    writeFrame(socket, handleRequest(engine, req, opts));
+                }
+                if (error) {
+                    qWarning() << "Invalid extractor request, closing connection.";
+                    socket->abort();
+                }
+            });
+        }
+    });
+
+    return QCoreApplication::exec();
+}
+
+bool ExtractorServer::request(const QString &socketName, const std::vector<ExtractionInput> &inputs, const ExtractionOptions &opts, bool ndjson, QCborMap &response)
+{
+    QLocalSocket socket;
+    socket.connectToServer(socketName);
+    if (!socket.waitForConnected(ConnectTimeout)) {
+        qDebug() << "No extractor server available:" << socket.errorString();
+        return false;
+    }
+
+    writeFrame(&socket, encodeRequest(inputs, opts, ndjson));
+    QByteArray buffer;
+    bool error = false;
+    while (!readFrame(buffer, response, error)) {
+        if (error || !socket.waitForReadyRead(ResponseTimeout)) {
+            qWarning() << "Extractor server request failed:" << socket.errorString();
+            return false;
+        }
+        buffer.append(socket.readAll());
+    }
+    return true;
+}
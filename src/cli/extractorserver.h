@@ -0,0 +1,33 @@
+/*
+    SPDX-FileCopyrightText: 2026 KItinerary contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KITINERARY_CLI_EXTRACTORSERVER_H
+#define KITINERARY_CLI_EXTRACTORSERVER_H
+
+#include "extraction.h"
+
+#include <QCborMap>
+
+/** Resident extractor mode, avoiding the startup cost for each invocation.
+ *
+ *  Requests and responses are CBOR maps, each prefixed by its size as
+ *  32bit big-endian integer. A request contains the inputs (file name,
+ *  MIME type and data), the context date, additional extractors, whether
+ *  to validate results and whether to produce NDJSON output. The response
+ *  contains either the post-processed result, the NDJSON lines or an error.
+ */
+namespace ExtractorServer
+{
+/** Listen on local socket @p socketName and serve extraction requests until terminated. */
+[[nodiscard]] int serve(const QString &socketName, const ExtractionOptions &opts);
+
+/** Send an extraction request to the server at @p socketName.
+ *  @returns @c false if no server is available, extraction should be done in process then.
+ */
+[[nodiscard]] bool request(const QString &socketName, const std::vector<ExtractionInput> &inputs, const ExtractionOptions &opts, bool ndjson, QCborMap &response);
+}
+
+#endif // KITINERARY_CLI_EXTRACTORSERVER_H
@@ -7,12 +7,15 @@
 #include <config-kitinerary.h>
 #include <kitinerary_version.h>
 
+#include "extraction.h"
+#if HAVE_EXTRACTOR_SERVER
+#include "extractorserver.h"
+#endif
+
 #include <KItinerary/CalendarHandler>
 #include <KItinerary/ExtractorCapabilities>
 #include <KItinerary/ExtractorEngine>
-#include <KItinerary/ExtractorPostprocessor>
 #include <KItinerary/ExtractorRepository>
-#include <KItinerary/ExtractorValidator>
 #include <KItinerary/JsonLdDocument>
 #include <KItinerary/MergeUtil>
 #include <KItinerary/Reservation>
@@ -22,6 +25,9 @@
 #include <KCalendarCore/ICalFormat>
 #include <KCalendarCore/MemoryCalendar>
 
+#if HAVE_EXTRACTOR_SERVER
+#include <QCborArray>
+#endif
 #include <QCommandLineParser>
 #include <QCoreApplication>
 #include <QDateTime>
@@ -31,9 +37,15 @@
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QMutex>
 #include <QObject>
+#include <QStandardPaths>
+#include <QThread>
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <memory>
 
 using namespace KItinerary;
 
@@ -72,6 +84,26 @@ batchReservations(const QList<QVariant> &reservations) {
   return batches;
 }
 
+static void printResult(const QList<QVariant> &result, bool ical)
+{
+    if (ical) {
+      const auto batches = batchReservations(result);
+      KCalendarCore::Calendar::Ptr cal(
+          new KCalendarCore::MemoryCalendar(QTimeZone::systemTimeZone()));
+      for (const auto &batch : batches) {
+        KCalendarCore::Event::Ptr event(new KCalendarCore::Event);
+        CalendarHandler::fillEvent(batch, event);
+        cal->addEvent(event);
+      }
+      KCalendarCore::ICalFormat format;
+      std::cout << qPrintable(format.toString(cal));
+    } else {
+      const auto postProcResult = JsonLdDocument::toJson(result);
+      std::cout << QJsonDocument(postProcResult).toJson().constData()
+                << std::endl;
+    }
+}
+
 static void printCapabilities()
 {
     std::cout << qPrintable(ExtractorCapabilities::capabilitiesString());
@@ -130,10 +162,28 @@ int main(int argc, char** argv)
     parser.addOption(extOpt);
     QCommandLineOption pathsOpt({QStringLiteral("additional-search-path")}, QStringLiteral("Additional search path for extractors."), QStringLiteral("search-path"));
     parser.addOption(pathsOpt);
-    QCommandLineOption formatOpt({QStringLiteral("o"), QStringLiteral("output")}, QStringLiteral("Output format [JsonLd, iCal]. Default: JsonLd"), QStringLiteral("format"));
+    QCommandLineOption formatOpt({QStringLiteral("o"), QStringLiteral("output"), QStringLiteral("output-format")}, QStringLiteral("Output format [JsonLd, iCal, NdJson]. Default: JsonLd"), QStringLiteral("format"));
     parser.addOption(formatOpt);
     QCommandLineOption noValidationOpt({QStringLiteral("no-validation")}, QStringLiteral("Disable result validation."));
     parser.addOption(noValidationOpt);
+    QCommandLineOption cacheOpt({QStringLiteral("cache")}, QStringLiteral("Cache extraction results persistently."));
+    parser.addOption(cacheOpt);
+    QCommandLineOption cacheDirOpt({QStringLiteral("cache-dir")}, QStringLiteral("Directory for the extraction result cache, implies --cache."), QStringLiteral("path"));
+    parser.addOption(cacheDirOpt);
+    QCommandLineOption cacheSizeOpt({QStringLiteral("cache-size")}, QStringLiteral("Maximum size of the extraction result cache in MiB. Default: 64"), QStringLiteral("size"));
+    parser.addOption(cacheSizeOpt);
+    QCommandLineOption jobsOpt({QStringLiteral("j"), QStringLiteral("jobs")}, QStringLiteral("Number of input files to process in parallel. Default: 1"), QStringLiteral("count"));
+    parser.addOption(jobsOpt);
+    QCommandLineOption statsOpt({QStringLiteral("stats")}, QStringLiteral("Print timing statistics for all processing steps to stderr."));
+    parser.addOption(statsOpt);
+    QCommandLineOption traceOpt({QStringLiteral("trace")}, QStringLiteral("Write a timeline of all processing steps in Chrome trace event format to the given file, implies in-process extraction."), QStringLiteral("file"));
+    parser.addOption(traceOpt);
+#if HAVE_EXTRACTOR_SERVER
+    QCommandLineOption serveOpt({QStringLiteral("serve")}, QStringLiteral("Run as resident extractor server on the given local socket."), QStringLiteral("socket"));
+    parser.addOption(serveOpt);
+    QCommandLineOption connectOpt({QStringLiteral("connect")}, QStringLiteral("Send extraction requests to the extractor server on the given local socket, if available."), QStringLiteral("socket"));
+    parser.addOption(connectOpt);
+#endif
 
     parser.addPositionalArgument(QStringLiteral("input"), QStringLiteral("File to extract data from, omit for using stdin."));
     parser.process(app);
@@ -153,74 +203,149 @@ int main(int argc, char** argv)
         return 0;
     }
 
-    ExtractorEngine engine;
-    engine.setUseSeparateProcess(false); // we are the external extractor
-    ExtractorPostprocessor postproc;
-
-    auto contextDt = QDateTime::fromString(parser.value(ctxOpt), Qt::ISODate);
-    if (!contextDt.isValid()) {
-        contextDt = QDateTime::currentDateTime();
+    ExtractionOptions opts;
+    opts.contextDate = QDateTime::fromString(parser.value(ctxOpt), Qt::ISODate);
+    if (!opts.contextDate.isValid()) {
+        opts.contextDate = QDateTime::currentDateTime();
+    }
+    opts.extractors = parser.value(extOpt).split(QLatin1Char(';'), Qt::SkipEmptyParts);
+    if (parser.isSet(cacheOpt) || parser.isSet(cacheDirOpt)) {
+        opts.cacheDir = parser.value(cacheDirOpt);
+        if (opts.cacheDir.isEmpty()) {
+            opts.cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1StringView("/extractor-results");
+        }
+        bool ok = false;
+        const auto cacheSize = parser.value(cacheSizeOpt).toLongLong(&ok);
+        if (ok && cacheSize > 0) {
+            opts.cacheSize = cacheSize * 1024 * 1024;
+        }
     }
-    postproc.setContextDate(contextDt);
+    opts.validate = !parser.isSet(noValidationOpt);
+    opts.statistics = parser.isSet(statsOpt);
+    opts.trace = parser.isSet(traceOpt);
 
     const auto files = parser.positionalArguments().isEmpty() ? QStringList(QString()) : parser.positionalArguments();
-    for (const auto &arg : files) {
-        QFile f;
-        if (!arg.isEmpty()) {
-            f.setFileName(arg);
-            if (!f.open(QFile::ReadOnly)) {
-                std::cerr << qPrintable(f.errorString()) << std::endl;
+    const auto jobs = std::clamp<qsizetype>(parser.isSet(jobsOpt) ? parser.value(jobsOpt).toInt() : 1, 1, files.size());
+    const auto ndjson = parser.value(formatOpt).compare(QLatin1StringView("ndjson"), Qt::CaseInsensitive) == 0;
+    const auto ical = parser.value(formatOpt).compare(QLatin1StringView("ical"), Qt::CaseInsensitive) == 0;
+
+#if HAVE_EXTRACTOR_SERVER
+    if (parser.isSet(serveOpt)) {
+        return ExtractorServer::serve(parser.value(serveOpt), opts);
+    }
+#endif
+
+    std::vector<ExtractionInput> inputs;
+#if HAVE_EXTRACTOR_SERVER
+    if (parser.isSet(connectOpt) && !opts.trace) {
+        inputs.reserve(files.size());
+        for (const auto &arg : files) {
+            inputs.push_back(readInput(arg));
+        }
+        // falls back to in-process extraction if there is no server
+        QCborMap response;
+        if (ExtractorServer::request(parser.value(connectOpt), inputs, opts, ndjson, response)) {
+            if (ndjson) {
+                bool hasErrors = false;
+                for (const auto &line : response.value(QLatin1StringView("lines")).toArray()) {
+                    const auto obj = line.toMap().toJsonObject();
+                    hasErrors |= obj.contains(QLatin1StringView("error"));
+                    std::cout << QJsonDocument(obj).toJson(QJsonDocument::Compact).constData() << std::endl;
+                }
+                return hasErrors ? 1 : 0;
+            }
+            if (const auto error = response.value(QLatin1StringView("error")).toString(); !error.isEmpty()) {
+                std::cerr << qPrintable(error) << std::endl;
                 return 1;
             }
-        } else {
-            f.open(stdin, QFile::ReadOnly);
+            printResult(JsonLdDocument::fromJson(response.value(QLatin1StringView("result")).toArray().toJsonArray()), ical);
+            return 0;
         }
+    }
+#endif
 
-        auto fileName = f.fileName();
-
-        engine.clear();
-        engine.setContextDate(contextDt);
-
-        if (!parser.value(extOpt).isEmpty()) {
-            const auto extNames = parser.value(extOpt).split(QLatin1Char(';'),
-                                                             Qt::SkipEmptyParts);
-            std::vector<const AbstractExtractor*> exts;
-            exts.reserve(extNames.size());
-            for (const auto &name : extNames) {
-                const auto ext = repo.extractorByName(name);
-                exts.push_back(ext);
+    // in NDJSON mode results are written as soon as they are available, otherwise
+    // they are post-processed together in input order, independent of the number of jobs
+    std::vector<ExtractionResult> results(ndjson ? 0 : files.size());
+    std::atomic<qsizetype> nextFile = 0;
+    std::atomic<bool> hasErrors = false;
+    std::vector<ExtractorEngine::StatisticsEntry> stats;
+    QJsonArray traceEvents;
+    QMutex outputMutex;
+    const auto worker = [&](int job) {
+        ExtractorEngine engine;
+        setupEngine(engine, opts);
+        ExtractionTrace trace(job + 1, QLatin1StringView("job %1").arg(job + 1));
+        for (qsizetype i = nextFile++; i < files.size(); i = nextFile++) {
+            const auto start = std::chrono::steady_clock::now();
+            const auto input = inputs.empty() ? readInput(files.at(i)) : std::move(inputs[i]);
+            auto res = extract(engine, input, opts);
+            if (opts.trace) {
+                trace.record(QLatin1StringView("extract"), start, res.fileName);
+            }
+            if (!res.error.isEmpty()) {
+                hasErrors = true;
+            }
+            if (ndjson) {
+                const auto line = QJsonDocument(toNdJson(res, opts, opts.trace ? &trace : nullptr)).toJson(QJsonDocument::Compact);
+                QMutexLocker locker(&outputMutex);
+                std::cout << line.constData() << std::endl;
+            } else {
+                results[i] = std::move(res);
+            }
+        }
+        QMutexLocker locker(&outputMutex);
+        if (opts.statistics) {
+            mergeStatistics(stats, engine.statistics());
+        }
+        if (opts.trace) {
+            for (const auto &event : engine.traceEvents()) {
+                traceEvents.push_back(event);
+            }
+            for (const auto &event : trace.events) {
+                traceEvents.push_back(event);
             }
-            engine.setAdditionalExtractors(std::move(exts));
         }
+    };
 
-        engine.setData(f.readAll(), fileName);
-        const auto result = JsonLdDocument::fromJson(engine.extract());
-        postproc.process(result);
+    if (jobs == 1) {
+        worker(0);
+    } else {
+        std::vector<std::unique_ptr<QThread>> threads;
+        threads.reserve(jobs);
+        for (qsizetype i = 0; i < jobs; ++i) {
+            threads.emplace_back(QThread::create(worker, i));
+            threads.back()->start();
+        }
+        for (const auto &thread : threads) {
+            thread->wait();
+        }
     }
 
-    auto result = postproc.result();
-    if (!parser.isSet(noValidationOpt)) {
-        ExtractorValidator validator;
-        result.erase(std::remove_if(result.begin(), result.end(), [&validator](const auto &elem) {
-            return !validator.isValidElement(elem);
-        }), result.end());
+    if (opts.statistics) {
+        printStatistics(stats);
     }
 
-    if (parser.value(formatOpt).compare(QLatin1StringView("ical"),
-                                        Qt::CaseInsensitive) == 0) {
-      const auto batches = batchReservations(result);
-      KCalendarCore::Calendar::Ptr cal(
-          new KCalendarCore::MemoryCalendar(QTimeZone::systemTimeZone()));
-      for (const auto &batch : batches) {
-        KCalendarCore::Event::Ptr event(new KCalendarCore::Event);
-        CalendarHandler::fillEvent(batch, event);
-        cal->addEvent(event);
-      }
-      KCalendarCore::ICalFormat format;
-      std::cout << qPrintable(format.toString(cal));
-    } else {
-      const auto postProcResult = JsonLdDocument::toJson(result);
-      std::cout << QJsonDocument(postProcResult).toJson().constData()
-                << std::endl;
+    QList<QVariant> result;
+    if (!ndjson) {
+        for (const auto &res : results) {
+            if (!res.error.isEmpty()) {
+                std::cerr << qPrintable(res.error) << std::endl;
+                return 1;
+            }
+        }
+        ExtractionTrace trace(0, QStringLiteral("post-processing"));
+        result = postprocess(results, opts, opts.trace ? &trace : nullptr);
+        for (const auto &event : trace.events) {
+            traceEvents.push_back(event);
+        }
+    }
+    if (opts.trace && !writeTrace(parser.value(traceOpt), traceEvents)) {
+        return 1;
+    }
+
+    if (ndjson) {
+        return hasErrors ? 1 : 0;
     }
+    printResult(result, ical);
 }
@@ -6,6 +6,10 @@
 #include "bitvectorview.h"
 
 #include <QByteArray>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
 
 using namespace KItinerary;
 
@@ -33,13 +37,74 @@ uint8_t BitVectorView::at(BitVectorView::size_type index) const
     return (m_data.at(majIdx) & (1 << minIdx)) >> minIdx;
 }
 
+uint64_t BitVectorView::bitsAt(BitVectorView::size_type index, BitVectorView::size_type bits) const
+{
+    assert(bits <= MaxWordBits);
+    if (bits == 0) {
+        return 0;
+    }
+
+    const auto majIdx = index / 8;
+    uint64_t word = 0;
+    if (majIdx + 8 <= m_data.size()) {
+        word = qFromBigEndian<quint64>(m_data.data() + majIdx);
+    } else {
+        for (size_type i = 0; i < 8; ++i) {
+            word <<= 8;
+            if (majIdx + i < m_data.size()) {
+                word |= static_cast<uint8_t>(m_data[majIdx + i]);
+            }
+        }
+    }
+
+    return (word << (index % 8)) >> (64 - bits);
+}
+
 QByteArray BitVectorView::byteArrayAt(BitVectorView::size_type index, BitVectorView::size_type bytes) const
 {
-    QByteArray result;
-    result.reserve(bytes);
-    for (size_type i = 0; i < bytes; ++i) {
-        const auto b = valueAtMSB<uint8_t>(index + i * 8, 8);
-        result.push_back(b);
+    QByteArray result((qsizetype)bytes, Qt::Uninitialized);
+    auto out = result.data();
+
+    // byte-aligned: plain copy, zero-fill anything beyond the end
+    if (index % 8 == 0) {
+        const auto majIdx = index / 8;
+        const auto available = majIdx < m_data.size() ? std::min(bytes, m_data.size() - majIdx) : 0;
+        if (available > 0) {
+            std::memcpy(out, m_data.data() + majIdx, available);
+        }
+        std::memset(out + available, 0, bytes - available);
+        return result;
+    }
+
+    // unaligned: 7 bytes per 64 bit word read
+    size_type i = 0;
+    for (; i + 7 <= bytes; i += 7) {
+        const auto word = bitsAt(index + i * 8, 56);
+        for (size_type j = 0; j < 7; ++j) {
+            out[i + j] = static_cast<char>(word >> (48 - j * 8));
+        }
+    }
+    for (; i < bytes; ++i) {
+        out[i] = static_cast<char>(bitsAt(index + i * 8, 8));
+    }
+    return result;
+}
+
+QByteArray BitVectorView::sevenBitStringAt(BitVectorView::size_type index, BitVectorView::size_type count) const
+{
+    QByteArray result((qsizetype)count, Qt::Uninitialized);
+    auto out = result.data();
+
+    // 8 characters per 64 bit word read
+    size_type i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const auto word = bitsAt(index + i * 7, 56);
+        for (size_type j = 0; j < 8; ++j) {
+            out[i + j] = static_cast<char>((word >> (49 - j * 7)) & 0x7f);
+        }
+    }
+    for (; i < count; ++i) {
+        out[i] = static_cast<char>(bitsAt(index + i * 7, 7));
     }
     return result;
 }
@@ -41,30 +41,47 @@ public:
         static_assert(std::is_integral_v<T>);
         assert(size_type(sizeof(T) * 8) >= bits);
 
-        T result = {};
-        for (size_type i = 0; i < bits; ++i) {
-            result <<= 1;
-            result |= at(index + i);
+        if (bits <= MaxWordBits) {
+            return static_cast<T>(bitsAt(index, bits));
         }
-
-        return result;
+        const auto highBits = bits - 32;
+        return static_cast<T>((bitsAt(index, highBits) << 32) | bitsAt(index + highBits, 32));
     }
 
     /** Returns @p bytes starting at bit offset @p index. */
     QByteArray byteArrayAt(size_type index, size_type bytes) const;
 
+    /** Returns @p count 7-bit characters starting at bit offset @p index.
+     *  This is the packed representation used e.g. by ASN.1 IA5Strings.
+     */
+    QByteArray sevenBitStringAt(size_type index, size_type count) const;
+
     /** Reads a std::bitset from @p index. */
     template <std::size_t N>
     std::bitset<N> bitsetAt(size_type index) const
     {
-        std::bitset<N> result = {};
-        for (size_type i = 0; i < (size_type)N; ++i) {
-            result[N - i - 1] = at(index + i);
+        if constexpr (N <= 64) {
+            return std::bitset<N>(valueAtMSB<unsigned long long>(index, N));
+        } else {
+            std::bitset<N> result = {};
+            for (size_type i = 0; i < (size_type)N; ++i) {
+                result[N - i - 1] = at(index + i);
+            }
+            return result;
         }
-        return result;
     }
 
 private:
+    /** Maximum number of bits we can extract from a single 64 bit word
+     *  regardless of the bit alignment.
+     */
+    static constexpr size_type MaxWordBits = 57;
+
+    /** Read up to MaxWordBits bits at @p index, in MSB order.
+     *  Bits beyond the end of the data are read as 0.
+     */
+    uint64_t bitsAt(size_type index, size_type bits) const;
+
     std::string_view m_data;
 };
 
@@ -85,13 +85,8 @@ bool UPERDecoder::readBoolean()
 
 QByteArray UPERDecoder::readIA5StringData(size_type len)
 {
-    QByteArray result;
-    result.reserve(len);
-    for (size_type i = 0; i < len; ++i) {
-        const auto c = m_data.valueAtMSB<char>(m_idx, 7);
-        m_idx += 7;
-        result.push_back(c);
-    }
+    auto result = m_data.sevenBitStringAt(m_idx, len);
+    m_idx += len * 7;
     return result;
 }
 
@@ -8,11 +8,19 @@
 
 #include "barcodedecoder.h"
 #include "logging.h"
+#include "engine/extractorstatistics_p.h"
 
+#include <QCryptographicHash>
 #include <QDebug>
+#include <QHash>
 #include <QImage>
+#include <QRect>
 #include <QString>
 
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
 #define ZX_USE_UTF8 1
 #include <ZXing/ReadBarcode.h>
 
@@ -24,7 +32,11 @@ enum {
     MinSourceImageWidth = 26,
     // OEBB uses 1044x1044^W 2179x2179 for its UIC 918.3 Aztec code
     MaxSourceImageHeight = 2200,
-    MaxSourceImageWidth = 2200
+    MaxSourceImageWidth = 2200,
+    // images larger than this are tried at a reduced resolution first
+    MultiScaleMinImageSize = 1200,
+    // size the downscaled image should roughly have
+    MultiScaleTargetImageSize = 600,
 };
 
 
@@ -46,16 +58,68 @@ QString BarcodeDecoder::Result::toString() const
 }
 
 
-BarcodeDecoder::BarcodeDecoder() = default;
+namespace KItinerary {
+struct BarcodeRegionKey {
+    qint64 cacheKey;
+    QRect region;
+    [[nodiscard]] constexpr inline bool operator==(const BarcodeRegionKey &other) const
+    {
+        return cacheKey == other.cacheKey && region == other.region;
+    }
+};
+
+[[nodiscard]] static size_t qHash(const BarcodeRegionKey &key, size_t seed = 0)
+{
+    return qHashMulti(seed, key.cacheKey, key.region.x(), key.region.y(), key.region.width(), key.region.height());
+}
+
+class BarcodeDecoderPrivate
+{
+public:
+    void decodeIfNeeded(const QImage &img, BarcodeDecoder::BarcodeTypes hint, BarcodeDecoder::Result &result);
+    void decodeMultiIfNeeded(const QImage &img, BarcodeDecoder::BarcodeTypes hint, std::vector<BarcodeDecoder::Result> &results);
+    [[nodiscard]] std::vector<BarcodeDecoder::Result>& cacheEntry(const QImage &img);
+
+    std::unordered_map<qint64, std::vector<BarcodeDecoder::Result>> m_cache;
+    // image content digest to cache key, to share results between identical images from different sources
+    QHash<QByteArray, qint64> m_contentCache;
+    // source image and region to cache key of the cropped image
+    QHash<BarcodeRegionKey, qint64> m_regionCache;
+    BarcodeDecoder::Statistics m_statistics;
+    bool m_multiScaleDecoding = true;
+};
+}
+
+BarcodeDecoder::BarcodeDecoder()
+    : d(std::make_unique<BarcodeDecoderPrivate>())
+{
+}
+
+BarcodeDecoder::BarcodeDecoder(const BarcodeDecoder &other)
+    : d(std::make_unique<BarcodeDecoderPrivate>(*other.d))
+{
+}
+
+BarcodeDecoder::BarcodeDecoder(BarcodeDecoder &&other) noexcept = default;
 BarcodeDecoder::~BarcodeDecoder() = default;
 
+BarcodeDecoder& BarcodeDecoder::operator=(const BarcodeDecoder &other)
+{
+    if (this != &other) {
+        d = std::make_unique<BarcodeDecoderPrivate>(*other.d);
+    }
+    return *this;
+}
+
+BarcodeDecoder& BarcodeDecoder::operator=(BarcodeDecoder &&other) noexcept = default;
+
 BarcodeDecoder::Result BarcodeDecoder::decode(const QImage &img, BarcodeDecoder::BarcodeTypes hint) const
 {
     if ((hint & Any) == None || img.isNull()) {
         return {};
     }
 
-    auto &results = m_cache[img.cacheKey()];
+    auto &results = d->cacheEntry(img);
     if (results.size() > 1) {
         return Result{};
     }
@@ -63,19 +127,48 @@ BarcodeDecoder::Result BarcodeDecoder::decode(const QImage &img, BarcodeDecoder:
         results.push_back(Result{});
     }
     auto &result = results.front();
-    decodeIfNeeded(img, hint, result);
+    d->decodeIfNeeded(img, hint, result);
     return (result.positive & hint) ? result : Result{};
 }
 
+[[nodiscard]] static bool isMultiDecoded(const std::vector<BarcodeDecoder::Result> &results, BarcodeDecoder::BarcodeTypes hint)
+{
+    return std::any_of(results.begin(), results.end(), [hint](const auto &r) { return (r.positive & hint) || ((r.negative & hint) == hint); });
+}
+
+[[nodiscard]] static std::vector<BarcodeDecoder::Result> multiResults(const std::vector<BarcodeDecoder::Result> &results, BarcodeDecoder::BarcodeTypes hint)
+{
+    return (results.size() == 1 && (results[0].positive & hint) == 0) ? std::vector<BarcodeDecoder::Result>{} : results;
+}
+
 std::vector<BarcodeDecoder::Result> BarcodeDecoder::decodeMulti(const QImage &img, BarcodeDecoder::BarcodeTypes hint) const
 {
     if ((hint & Any) == None || img.isNull()) {
         return {};
     }
 
-    auto &results = m_cache[img.cacheKey()];
-    decodeMultiIfNeeded(img, hint, results);
-    return (results.size() == 1 && (results[0].positive & hint) == 0) ? std::vector<Result>{} : results;
+    auto &results = d->cacheEntry(img);
+    d->decodeMultiIfNeeded(img, hint, results);
+    return multiResults(results, hint);
+}
+
+std::vector<BarcodeDecoder::Result> BarcodeDecoder::decodeMulti(const QImage &img, const QRect &region, BarcodeDecoder::BarcodeTypes hint) const
+{
+    const auto rect = region & img.rect();
+    if ((hint & Any) == None || rect.isEmpty()) {
+        return {};
+    }
+    if (rect == img.rect()) {
+        return decodeMulti(img, hint);
+    }
+
+    auto &cropKey = d->m_regionCache[BarcodeRegionKey{img.cacheKey(), rect}];
+    if (const auto it = d->m_cache.find(cropKey); cropKey && it != d->m_cache.end() && isMultiDecoded((*it).second, hint)) {
+        return multiResults((*it).second, hint);
+    }
+    const auto crop = img.copy(rect);
+    cropKey = crop.cacheKey();
+    return decodeMulti(crop, hint);
 }
 
 QByteArray BarcodeDecoder::decodeBinary(const QImage &img, BarcodeDecoder::BarcodeTypes hint) const
@@ -90,7 +183,76 @@ QString BarcodeDecoder::decodeString(const QImage &img, BarcodeDecoder::BarcodeT
 
 void BarcodeDecoder::clearCache()
 {
-    m_cache.clear();
+    d->m_cache.clear();
+    d->m_contentCache.clear();
+    d->m_regionCache.clear();
+}
+
+qint64 BarcodeDecoder::cacheMemoryUsage() const
+{
+    // rough estimate of the hash node overhead
+    constexpr qint64 NodeOverhead = 2 * sizeof(void*);
+    constexpr qint64 DigestSize = 32;
+    qint64 size = d->m_contentCache.size() * (sizeof(QByteArray) + DigestSize + sizeof(qint64) + NodeOverhead)
+        + d->m_regionCache.size() * (sizeof(BarcodeRegionKey) + sizeof(qint64) + NodeOverhead);
+    for (const auto &entry : d->m_cache) {
+        size += sizeof(entry) + NodeOverhead;
+        for (const auto &result : entry.second) {
+            size += sizeof(Result);
+            switch (result.contentType) {
+                case Result::ByteArray:
+                    size += result.content.toByteArray().size();
+                    break;
+                case Result::String:
+                    size += result.content.toString().size() * sizeof(QChar);
+                    break;
+            }
+        }
+    }
+    return size;
+}
+
+// a cryptographic digest, as a collision would silently return the content of a different barcode
+static QByteArray imageContentDigest(const QImage &img)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    const int header[] = { img.width(), img.height(), img.format() };
+    hash.addData(QByteArrayView(reinterpret_cast<const char*>(header), sizeof(header)));
+    const auto lineSize = (img.width() * img.depth() + 7) / 8; // ignore padding at the end of scan lines
+    for (int y = 0; y < img.height(); ++y) {
+        hash.addData(QByteArrayView(reinterpret_cast<const char*>(img.constScanLine(y)), lineSize));
+    }
+    return hash.result();
+}
+
+std::vector<BarcodeDecoder::Result>& BarcodeDecoderPrivate::cacheEntry(const QImage &img)
+{
+    if (const auto it = m_cache.find(img.cacheKey()); it != m_cache.end()) {
+        return (*it).second;
+    }
+
+    // the same barcode image might be embedded several times in a document (e.g. on multiple pages),
+    // in which case we get different QImage instances for identical content
+    auto &results = m_cache[img.cacheKey()];
+    const auto digest = imageContentDigest(img);
+    if (const auto it = m_contentCache.constFind(digest); it != m_contentCache.constEnd()) {
+        if (const auto cacheIt = m_cache.find(it.value()); cacheIt != m_cache.end()) {
+            results = (*cacheIt).second;
+        }
+    } else {
+        m_contentCache.insert(digest, img.cacheKey());
+    }
+    return results;
+}
+
+void BarcodeDecoder::setMultiScaleDecodingEnabled(bool enabled)
+{
+    d->m_multiScaleDecoding = enabled;
+}
+
+BarcodeDecoder::Statistics BarcodeDecoder::statistics() const
+{
+    return d->m_statistics;
 }
 
 BarcodeDecoder::BarcodeTypes BarcodeDecoder::isPlausibleSize(int width, int height, BarcodeDecoder::BarcodeTypes hint)
@@ -232,6 +394,63 @@ static ZXing::ImageView zxingImageView(const QImage &img)
     return ZXing::ImageView{img.bits(), img.width(), img.height(), zxingImageFormat(img.format()), static_cast<int>(img.bytesPerLine())};
 }
 
+template <typename Hints>
+static auto zxingReadBarcode(const QImage &img, const Hints &hints)
+{
+    // convert if img is in a format ZXing can't handle directly
+    if (zxingImageFormat(img.format()) == ZXing::ImageFormat::None) {
+        return ZXing::ReadBarcode(zxingImageView(img.convertToFormat(QImage::Format_Grayscale8)), hints);
+    }
+    return ZXing::ReadBarcode(zxingImageView(img), hints);
+}
+
+#if KZXING_VERSION > QT_VERSION_CHECK(1, 2, 0)
+template <typename Hints>
+static auto zxingReadBarcodes(const QImage &img, const Hints &hints)
+{
+    // convert if img is in a format ZXing can't handle directly
+    if (zxingImageFormat(img.format()) == ZXing::ImageFormat::None) {
+        return ZXing::ReadBarcodes(zxingImageView(img.convertToFormat(QImage::Format_Grayscale8)), hints);
+    }
+    return ZXing::ReadBarcodes(zxingImageView(img), hints);
+}
+#endif
+
+/** Integer factor by which @p img should be downscaled for a first decoding attempt, 1 for none. */
+static int downscaleFactor(const QImage &img)
+{
+    const auto size = std::max(img.width(), img.height());
+    if (size < MultiScaleMinImageSize) {
+        return 1;
+    }
+    const auto factor = size / MultiScaleTargetImageSize;
+    return std::min(img.width(), img.height()) / factor > MinSourceImageHeight ? factor : 1;
+}
+
+/** Box-filtered downscaling of @p img by @p factor, converting it to grayscale on the way. */
+static QImage downscaled(const QImage &img, int factor)
+{
+    const auto src = img.format() == QImage::Format_Grayscale8 ? img : img.convertToFormat(QImage::Format_Grayscale8);
+    QImage out(src.width() / factor, src.height() / factor, QImage::Format_Grayscale8);
+    std::vector<int> sums(out.width());
+    for (int y = 0; y < out.height(); ++y) {
+        std::fill(sums.begin(), sums.end(), 0);
+        for (int dy = 0; dy < factor; ++dy) {
+            const auto srcLine = src.constScanLine(y * factor + dy);
+            for (int x = 0; x < out.width(); ++x) {
+                for (int dx = 0; dx < factor; ++dx) {
+                    sums[x] += srcLine[x * factor + dx];
+                }
+            }
+        }
+        auto outLine = out.scanLine(y);
+        for (int x = 0; x < out.width(); ++x) {
+            outLine[x] = sums[x] / (factor * factor);
+        }
+    }
+    return out;
+}
+
 #if KZXING_VERSION >= QT_VERSION_CHECK(2, 3, 0)
 static void applyZXingResult(BarcodeDecoder::Result &result, const ZXing::Barcode &zxingResult, BarcodeDecoder::BarcodeTypes format)
 #else
@@ -288,7 +507,7 @@ static void applyZXingResult(BarcodeDecoder::Result &result, const ZXing::Result
     }
 }
 
-void BarcodeDecoder::decodeIfNeeded(const QImage &img, BarcodeDecoder::BarcodeTypes hint, BarcodeDecoder::Result &result) const
+void BarcodeDecoderPrivate::decodeIfNeeded(const QImage &img, BarcodeDecoder::BarcodeTypes hint, BarcodeDecoder::Result &result)
 {
     if ((result.positive & hint) || (result.negative & hint) == hint) {
         return;
@@ -303,7 +522,7 @@ void BarcodeDecoder::decodeIfNeeded(const QImage &img, BarcodeDecoder::BarcodeTy
     hints.setBinarizer(ZXing::Binarizer::FixedThreshold);
     hints.setIsPure((hint & BarcodeDecoder::IgnoreAspectRatio) == 0);
 
-    // convert if img is in a format ZXing can't handle directly
+    // try large images at a lower resolution first, that's much cheaper and often good enough
 #if KZXING_VERSION >= QT_VERSION_CHECK(2, 3, 0)
     ZXing::Barcode res;
 #elif KZXING_VERSION > QT_VERSION_CHECK(1, 3, 0)
@@ -311,19 +530,30 @@ void BarcodeDecoder::decodeIfNeeded(const QImage &img, BarcodeDecoder::BarcodeTy
 #else
     ZXing::Result res(ZXing::DecodeStatus::NotFound);
 #endif
-    if (zxingImageFormat(img.format()) == ZXing::ImageFormat::None) {
-        res = ZXing::ReadBarcode(zxingImageView(img.convertToFormat(QImage::Format_Grayscale8)), hints);
-    } else {
-        res = ZXing::ReadBarcode(zxingImageView(img), hints);
+    ExtractorStatistics::Timer timer(ExtractorStatistics::current(), ExtractorStatistics::DecodeBarcode);
+    if (const auto factor = m_multiScaleDecoding ? downscaleFactor(img) : 1; factor > 1) {
+        ++m_statistics.downscaledAttempts;
+        res = zxingReadBarcode(downscaled(img, factor), hints);
+        if (res.isValid()) {
+            ++m_statistics.downscaledHits;
+        }
+    }
+    if (!res.isValid()) {
+        ++m_statistics.fullResolutionAttempts;
+        res = zxingReadBarcode(img, hints);
+        if (res.isValid()) {
+            ++m_statistics.fullResolutionHits;
+        }
     }
+    timer.stop(u"decode", res.isValid());
 
     applyZXingResult(result, res, hint);
 }
 
-void BarcodeDecoder::decodeMultiIfNeeded(const QImage &img, BarcodeDecoder::BarcodeTypes hint, std::vector<BarcodeDecoder::Result> &results) const
+void BarcodeDecoderPrivate::decodeMultiIfNeeded(const QImage &img, BarcodeDecoder::BarcodeTypes hint, std::vector<BarcodeDecoder::Result> &results)
 {
 #if KZXING_VERSION > QT_VERSION_CHECK(1, 2, 0)
-    if (std::any_of(results.begin(), results.end(), [hint](const auto &r) { return (r.positive & hint) || ((r.negative & hint) == hint); })) {
+    if (isMultiDecoded(results, hint)) {
         return;
     }
 
@@ -336,17 +566,15 @@ void BarcodeDecoder::decodeMultiIfNeeded(const QImage &img, BarcodeDecoder::Barc
     hints.setBinarizer(ZXing::Binarizer::FixedThreshold);
     hints.setIsPure(false);
 
-    // convert if img is in a format ZXing can't handle directly
-#if KZXING_VERSION >= QT_VERSION_CHECK(2, 3, 0)
-    std::vector<ZXing::Barcode> zxingResults;
-#else
-    std::vector<ZXing::Result> zxingResults;
-#endif
-    if (zxingImageFormat(img.format()) == ZXing::ImageFormat::None) {
-        zxingResults = ZXing::ReadBarcodes(zxingImageView(img.convertToFormat(QImage::Format_Grayscale8)), hints);
-    } else {
-        zxingResults = ZXing::ReadBarcodes(zxingImageView(img), hints);
+    // no reduced resolution attempt here, finding some barcodes that way doesn't mean
+    // there aren't further smaller ones we would then miss
+    ExtractorStatistics::Timer timer(ExtractorStatistics::current(), ExtractorStatistics::DecodeBarcode);
+    ++m_statistics.fullResolutionAttempts;
+    const auto zxingResults = zxingReadBarcodes(img, hints);
+    if (!zxingResults.empty()) {
+        ++m_statistics.fullResolutionHits;
     }
+    timer.stop(u"decodeMulti", !zxingResults.empty());
 
     if (zxingResults.empty()) {
         Result r;
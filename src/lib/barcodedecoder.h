@@ -11,14 +11,17 @@
 #include <QFlags>
 #include <QVariant>
 
-#include <unordered_map>
+#include <memory>
 
 class QByteArray;
 class QImage;
+class QRect;
 class QString;
 
 namespace KItinerary {
 
+class BarcodeDecoderPrivate;
+
 /** Barcode decoding with result caching.
  *  All non-static functions are using heuristics and cached results before actually
  *  performing an expensive barcode decoding operation, so repreated calls or calls with
@@ -31,7 +34,11 @@ class KITINERARY_EXPORT BarcodeDecoder
 {
 public:
     BarcodeDecoder();
+    BarcodeDecoder(const BarcodeDecoder &other);
+    BarcodeDecoder(BarcodeDecoder &&other) noexcept;
     ~BarcodeDecoder();
+    BarcodeDecoder& operator=(const BarcodeDecoder &other);
+    BarcodeDecoder& operator=(BarcodeDecoder &&other) noexcept;
 
     enum BarcodeType {
         Aztec = 1,
@@ -83,6 +90,11 @@ public:
      *  @param hint IgnoreAspectRatio is implied here
      */
     std::vector<Result> decodeMulti(const QImage &img, BarcodeTypes hint) const;
+    /** Decodes multiple barcodes in the area @p region of @p img.
+     *  Unlike decoding a copy of that area this is cached by source image and region.
+     *  @since 26.12
+     */
+    std::vector<Result> decodeMulti(const QImage &img, const QRect &region, BarcodeTypes hint) const;
 
     /** Decodes a binary payload barcode in @p img of type @p hint.
      *  @param hint has to be validated by something of the likes of maybeBarcode()
@@ -98,6 +110,37 @@ public:
 
     /** Clears the internal cache. */
     void clearCache();
+    /** Approximate amount of memory used by the internal cache, in bytes.
+     *  @since 26.12
+     */
+    qint64 cacheMemoryUsage() const;
+
+    /** Enables or disables decoding large images at a reduced resolution first.
+     *  Full resolution decoding is only attempted when that fails then.
+     *  This only applies to decode(), decodeMulti() always searches the full resolution
+     *  image, as a hit at a reduced resolution doesn't rule out further smaller barcodes.
+     *  This is enabled by default.
+     *  @since 26.12
+     */
+    void setMultiScaleDecodingEnabled(bool enabled);
+
+    /** Statistics about the decoding attempts made by this instance.
+     *  @since 26.12
+     */
+    struct Statistics {
+        /** Decoding attempts on downscaled images. */
+        int downscaledAttempts = 0;
+        /** Successful decoding attempts on downscaled images. */
+        int downscaledHits = 0;
+        /** Decoding attempts on full resolution images. */
+        int fullResolutionAttempts = 0;
+        /** Successful decoding attempts on full resolution images. */
+        int fullResolutionHits = 0;
+    };
+    /** Returns statistics about the decoding attempts made so far.
+     *  @since 26.12
+     */
+    Statistics statistics() const;
 
     /** Checks if the given image dimensions are plausible for a barcode.
      *  These checks are done first by BarcodeDecoder, it might however useful
@@ -115,10 +158,7 @@ public:
     static BarcodeTypes maybeBarcode(int width, int height, BarcodeTypes hint);
 
 private:
-    void decodeIfNeeded(const QImage &img, BarcodeTypes hint, Result &result) const;
-    void decodeMultiIfNeeded(const QImage &img, BarcodeTypes hint, std::vector<Result> &results) const;
-
-    mutable std::unordered_map<qint64, std::vector<Result>> m_cache;
+    std::unique_ptr<BarcodeDecoderPrivate> d;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(BarcodeDecoder::BarcodeTypes)
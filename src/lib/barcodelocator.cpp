@@ -0,0 +1,205 @@
+/*
+    SPDX-FileCopyrightText: 2026 KItinerary contributors
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "barcodelocator_p.h"
+
+#include <QImage>
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+using namespace KItinerary;
+
+enum {
+    TileSize = 16, // in pixels
+    // mean absolute horizontal plus vertical gradient per pixel
+    MinTileGradient = 24,
+    // share of dark pixels in a tile, in percent
+    MinTileDarkRatio = 30,
+    MaxTileDarkRatio = 70,
+    DarkThreshold = 128,
+    // minimum number of tiles in a candidate region
+    MinRegionTiles = 6,
+    // margin added around candidate regions to retain the quiet zone, in tiles
+    RegionMargin = 1,
+    MaxRegions = 8,
+    // maximum area of a candidate region, in percent of the image area
+    MaxRegionArea = 50,
+};
+
+enum TileClass : uint8_t {
+    EmptyTile = 0,
+    DarkTile = 1, // enough dark pixels that this could be part of a barcode
+    CandidateTile = 2, // looks like a barcode
+};
+
+static TileClass classifyTile(const QImage &img, int tileX, int tileY)
+{
+    const auto x0 = tileX * TileSize;
+    const auto y0 = tileY * TileSize;
+    const auto x1 = std::min(x0 + TileSize, img.width() - 1);
+    const auto y1 = std::min(y0 + TileSize, img.height() - 1);
+    if (x1 <= x0 || y1 <= y0) {
+        return EmptyTile;
+    }
+
+    int gradient = 0;
+    int dark = 0;
+    for (int y = y0; y < y1; ++y) {
+        const auto line = img.constScanLine(y);
+        const auto nextLine = img.constScanLine(y + 1);
+        for (int x = x0; x < x1; ++x) {
+            gradient += std::abs(line[x + 1] - line[x]) + std::abs(nextLine[x] - line[x]);
+            dark += line[x] < DarkThreshold ? 1 : 0;
+        }
+    }
+
+    const auto pixels = (x1 - x0) * (y1 - y0);
+    if (dark * 100 < MinTileDarkRatio * pixels) {
+        return EmptyTile;
+    }
+    return gradient >= MinTileGradient * pixels && dark * 100 <= MaxTileDarkRatio * pixels ? CandidateTile : DarkTile;
+}
+
+static constexpr const std::pair<int, int> neighborOffsets[] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1} };
+
+/** Checks whether any sufficiently large group of dark tiles is outside of @p regions. */
+static bool hasUncoveredDarkArea(const std::vector<uint8_t> &tiles, int columns, int rows, const std::vector<QRect> &regions, const QRect &imgRect)
+{
+    std::vector<uint8_t> uncovered(tiles.size(), 0);
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < columns; ++x) {
+            if (tiles[y * columns + x] == EmptyTile) {
+                continue;
+            }
+            const auto tileRect = QRect(x * TileSize, y * TileSize, TileSize, TileSize) & imgRect;
+            uncovered[y * columns + x] = std::none_of(regions.begin(), regions.end(), [&tileRect](const auto &region) {
+                return region.contains(tileRect);
+            });
+        }
+    }
+
+    std::vector<int> stack;
+    for (int i = 0; i < columns * rows; ++i) {
+        if (!uncovered[i]) {
+            continue;
+        }
+        QRect bbox;
+        uncovered[i] = 0;
+        stack.push_back(i);
+        while (!stack.empty()) {
+            const auto idx = stack.back();
+            stack.pop_back();
+            const auto x = idx % columns;
+            const auto y = idx / columns;
+            bbox |= QRect(x, y, 1, 1);
+            for (const auto &[ox, oy] : neighborOffsets) {
+                const auto nx = x + ox;
+                const auto ny = y + oy;
+                if (nx < 0 || ny < 0 || nx >= columns || ny >= rows || !uncovered[ny * columns + nx]) {
+                    continue;
+                }
+                uncovered[ny * columns + nx] = 0;
+                stack.push_back(ny * columns + nx);
+            }
+        }
+        // same assumption as for candidate regions, thin areas are lines or borders
+        if (bbox.width() >= 2 && bbox.height() >= 2) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<QRect> BarcodeLocator::findCandidateRegions(const QImage &img, bool *isComplete)
+{
+    if (isComplete) {
+        *isComplete = false;
+    }
+    if (img.isNull()) {
+        return {};
+    }
+    const auto grayImg = img.format() == QImage::Format_Grayscale8 ? img : img.convertToFormat(QImage::Format_Grayscale8);
+
+    // classify tiles, dilated by one tile so that modules with quiet areas in between still form one region
+    const auto columns = (grayImg.width() + TileSize - 1) / TileSize;
+    const auto rows = (grayImg.height() + TileSize - 1) / TileSize;
+    std::vector<uint8_t> tiles(columns * rows, EmptyTile);
+    std::vector<uint8_t> mask(columns * rows, 0);
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < columns; ++x) {
+            tiles[y * columns + x] = classifyTile(grayImg, x, y);
+            if (tiles[y * columns + x] != CandidateTile) {
+                continue;
+            }
+            for (int dy = std::max(0, y - 1); dy <= std::min(rows - 1, y + 1); ++dy) {
+                for (int dx = std::max(0, x - 1); dx <= std::min(columns - 1, x + 1); ++dx) {
+                    mask[dy * columns + dx] = 1;
+                }
+            }
+        }
+    }
+
+    // connected regions of the dilated mask
+    std::vector<QRect> regions;
+    bool droppedRegions = false;
+    std::vector<int> stack;
+    for (int i = 0; i < columns * rows; ++i) {
+        if (!mask[i]) {
+            continue;
+        }
+
+        int tileCount = 0;
+        QRect bbox;
+        mask[i] = 0;
+        stack.push_back(i);
+        while (!stack.empty()) {
+            const auto idx = stack.back();
+            stack.pop_back();
+            const auto x = idx % columns;
+            const auto y = idx / columns;
+            if (tiles[idx] == CandidateTile) {
+                ++tileCount;
+                bbox |= QRect(x, y, 1, 1);
+            }
+            for (const auto &[ox, oy] : neighborOffsets) {
+                const auto nx = x + ox;
+                const auto ny = y + oy;
+                if (nx < 0 || ny < 0 || nx >= columns || ny >= rows || !mask[ny * columns + nx]) {
+                    continue;
+                }
+                mask[ny * columns + nx] = 0;
+                stack.push_back(ny * columns + nx);
+            }
+        }
+
+        // thin regions are rather lines or borders, even 1D barcodes span at least two rows of tiles
+        if (tileCount < MinRegionTiles || bbox.width() < 2 || bbox.height() < 2) {
+            continue;
+        }
+        bbox.adjust(-RegionMargin, -RegionMargin, RegionMargin, RegionMargin);
+        const auto region = QRect(bbox.x() * TileSize, bbox.y() * TileSize, bbox.width() * TileSize, bbox.height() * TileSize) & grayImg.rect();
+        // regions covering most of the image are better handled by decoding the full image directly
+        if (region.width() * region.height() * 100 > MaxRegionArea * grayImg.width() * grayImg.height()) {
+            droppedRegions = true;
+            continue;
+        }
+        regions.push_back(region);
+    }
+
+    std::sort(regions.begin(), regions.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.width() * lhs.height() > rhs.width() * rhs.height();
+    });
+    if (regions.size() > (std::size_t)MaxRegions) {
+        regions.resize(MaxRegions);
+        droppedRegions = true;
+    }
+
+    if (isComplete) {
+        *isComplete = !droppedRegions && !hasUncoveredDarkArea(tiles, columns, rows, regions, grayImg.rect());
+    }
+    return regions;
+}
@@ -0,0 +1,42 @@
+/*
+    SPDX-FileCopyrightText: 2026 KItinerary contributors
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KITINERARY_BARCODELOCATOR_H
+#define KITINERARY_BARCODELOCATOR_H
+
+#include "kitinerary_export.h"
+
+#include <QRect>
+
+#include <vector>
+
+class QImage;
+
+namespace KItinerary {
+
+/** Finds areas in large images (such as full page raster images) that might contain barcodes.
+ *  This is based on tile-level statistics: barcodes have a high contrast and gradient density
+ *  and an almost even share of dark and light pixels, while text, photos or empty areas don't.
+ *  Decoding only those areas is a lot cheaper than searching the entire image.
+ */
+namespace BarcodeLocator
+{
+    /** Minimum size (longer side, in pixels) for images where localization is worth it. */
+    constexpr inline int MinImageSize = 800;
+
+    /** Returns candidate barcode regions in @p img, largest first.
+     *  @param isComplete If set, this is set to @c true if the returned regions cover every
+     *  non-trivial dark area of the image, ie. decoding anything outside of them can't yield
+     *  further barcodes. This is @c false if there are dark areas that don't look like a barcode
+     *  to the tile heuristics (e.g. very large modules or low contrast), or if candidate regions
+     *  were dropped due to their size or number.
+     *  @internal exported for unit tests only
+     */
+    [[nodiscard]] KITINERARY_EXPORT std::vector<QRect> findCandidateRegions(const QImage &img, bool *isComplete = nullptr);
+}
+
+}
+
+#endif // KITINERARY_BARCODELOCATOR_H
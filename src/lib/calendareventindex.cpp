@@ -0,0 +1,241 @@
+/*
+   SPDX-FileCopyrightText: 2026 KItinerary contributors
+
+   SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "calendareventindex.h"
+#include "calendarhandler.h"
+#include "calendarhandler_p.h"
+#include "mergeutil.h"
+
+#include <KItinerary/Event>
+#include <KItinerary/Reservation>
+#include <KItinerary/Ticket>
+
+#include <KCalendarCore/Calendar>
+#include <KCalendarCore/Event>
+
+#include <QHash>
+#include <QPointer>
+
+#include <algorithm>
+
+using namespace Qt::Literals::StringLiterals;
+using namespace KItinerary;
+
+namespace KItinerary {
+class CalendarEventIndexPrivate : public KCalendarCore::Calendar::CalendarObserver
+{
+public:
+    struct Entry {
+        KCalendarCore::Event::Ptr event;
+        QDateTime lastModified;
+        int revision = 0;
+        QList<QVariant> reservations;
+        QList<MergeUtil::Fingerprint> fingerprints;
+        QStringList reservationNumbers;
+    };
+
+    [[nodiscard]] const Entry& entry(const KCalendarCore::Event::Ptr &event);
+    void insertEntry(const KCalendarCore::Event::Ptr &event);
+    void removeEntry(const QString &uid);
+    void populateNumberIndex();
+
+    void calendarIncidenceAdded(const KCalendarCore::Incidence::Ptr &incidence) override;
+    void calendarIncidenceChanged(const KCalendarCore::Incidence::Ptr &incidence) override;
+    void calendarIncidenceDeleted(const KCalendarCore::Incidence::Ptr &incidence, const KCalendarCore::Calendar *calendar) override;
+
+    QPointer<KCalendarCore::Calendar> calendar;
+    QHash<QString, Entry> entries;
+    // reservation number -> event uid, only valid once complete
+    QMultiHash<QString, QString> numberIndex;
+    bool numberIndexComplete = false;
+};
+}
+
+[[nodiscard]] static bool isItineraryEvent(const KCalendarCore::Event::Ptr &event)
+{
+    return event->uid().startsWith("KIT-"_L1);
+}
+
+const CalendarEventIndexPrivate::Entry& CalendarEventIndexPrivate::entry(const KCalendarCore::Event::Ptr &event)
+{
+    auto it = entries.constFind(event->uid());
+    if (it != entries.constEnd() && (*it).event == event && (*it).revision == event->revision() && (*it).lastModified == event->lastModified()) {
+        return *it;
+    }
+    insertEntry(event);
+    return *entries.constFind(event->uid());
+}
+
+void CalendarEventIndexPrivate::insertEntry(const KCalendarCore::Event::Ptr &event)
+{
+    removeEntry(event->uid());
+
+    Entry e;
+    e.event = event;
+    e.lastModified = event->lastModified();
+    e.revision = event->revision();
+    e.reservations = CalendarHandler::reservationsForEvent(event);
+    e.fingerprints.reserve(e.reservations.size());
+    for (const auto &res : std::as_const(e.reservations)) {
+        e.fingerprints.push_back(MergeUtil::fingerprint(res));
+        if (!JsonLd::canConvert<Reservation>(res)) {
+            continue;
+        }
+        const auto num = JsonLd::convert<Reservation>(res).reservationNumber();
+        if (!num.isEmpty() && !e.reservationNumbers.contains(num)) {
+            e.reservationNumbers.push_back(num);
+            numberIndex.insert(num, event->uid());
+        }
+    }
+    entries.insert(event->uid(), std::move(e));
+}
+
+void CalendarEventIndexPrivate::removeEntry(const QString &uid)
+{
+    const auto it = entries.find(uid);
+    if (it == entries.end()) {
+        return;
+    }
+    for (const auto &num : std::as_const((*it).reservationNumbers)) {
+        numberIndex.remove(num, uid);
+    }
+    entries.erase(it);
+}
+
+void CalendarEventIndexPrivate::populateNumberIndex()
+{
+    if (numberIndexComplete) {
+        return;
+    }
+    const auto events = calendar->rawEvents();
+    for (const auto &event : events) {
+        if (isItineraryEvent(event)) {
+            (void)entry(event);
+        }
+    }
+    numberIndexComplete = true;
+}
+
+void CalendarEventIndexPrivate::calendarIncidenceAdded(const KCalendarCore::Incidence::Ptr &incidence)
+{
+    calendarIncidenceChanged(incidence);
+}
+
+void CalendarEventIndexPrivate::calendarIncidenceChanged(const KCalendarCore::Incidence::Ptr &incidence)
+{
+    removeEntry(incidence->uid());
+    // the number index needs to know about all events, everything else is decoded lazily
+    if (numberIndexComplete && incidence->type() == KCalendarCore::IncidenceBase::TypeEvent) {
+        const auto event = incidence.staticCast<KCalendarCore::Event>();
+        if (isItineraryEvent(event)) {
+            insertEntry(event);
+        }
+    }
+}
+
+void CalendarEventIndexPrivate::calendarIncidenceDeleted(const KCalendarCore::Incidence::Ptr &incidence, const KCalendarCore::Calendar *calendar)
+{
+    Q_UNUSED(calendar);
+    removeEntry(incidence->uid());
+}
+
+CalendarEventIndex::CalendarEventIndex(KCalendarCore::Calendar *calendar)
+    : d(std::make_unique<CalendarEventIndexPrivate>())
+{
+    d->calendar = calendar;
+    if (calendar) {
+        calendar->registerObserver(d.get());
+    }
+}
+
+CalendarEventIndex::~CalendarEventIndex()
+{
+    if (d->calendar) {
+        d->calendar->unregisterObserver(d.get());
+    }
+}
+
+// a minimal cancellation without a ticket token can only match events with the same reservation number
+// (see MergeUtil::isSame), so we can look those up directly
+[[nodiscard]] static bool canUseNumberIndex(const QVariant &reservation)
+{
+    if (!JsonLd::canConvert<Reservation>(reservation)) {
+        return false;
+    }
+    const auto res = JsonLd::convert<Reservation>(reservation);
+    return res.reservationFor().isNull() && !res.reservationNumber().isEmpty() && res.reservedTicket().value<Ticket>().ticketToken().isEmpty();
+}
+
+// same overlap semantics as KCalendarCore::Calendar::events() for a date range
+[[nodiscard]] static bool isInRange(const KCalendarCore::Event::Ptr &event, const CalendarHandler::SearchRange &range, const QTimeZone &tz)
+{
+    const auto toDate = [&event, &tz](const QDateTime &dt) {
+        return event->allDay() ? dt.date() : dt.toTimeZone(tz).date();
+    };
+    const auto start = toDate(event->dtStart());
+    const auto end = event->hasEndDate() ? toDate(event->dtEnd()) : start;
+    return start <= range.end && end >= range.start;
+}
+
+QList<QSharedPointer<KCalendarCore::Event>> CalendarEventIndex::findEvents(const QVariant &reservation)
+{
+    if (!(JsonLd::canConvert<Reservation>(reservation) || JsonLd::canConvert<KItinerary::Event>(reservation)) || !d->calendar) {
+        return {};
+    }
+
+    const auto range = CalendarHandler::searchRange(d->calendar, reservation);
+    if (!range.start.isValid()) {
+        return {};
+    }
+
+    QList<KCalendarCore::Event::Ptr> events;
+    if (range.end.isValid() && canUseNumberIndex(reservation)) {
+        d->populateNumberIndex();
+        const auto uids = d->numberIndex.values(JsonLd::convert<Reservation>(reservation).reservationNumber());
+        for (const auto &uid : uids) {
+            const auto event = d->entries.value(uid).event;
+            if (event && isInRange(event, range, d->calendar->timeZone())) {
+                events.push_back(event);
+            }
+        }
+        // deterministic result order, the calendar doesn't sort either
+        std::sort(events.begin(), events.end(), [](const auto &lhs, const auto &rhs) {
+            return lhs->dtStart() < rhs->dtStart();
+        });
+    } else {
+        events = CalendarHandler::eventsInRange(d->calendar, range);
+    }
+
+    QList<KCalendarCore::Event::Ptr> results;
+    const auto fp = MergeUtil::fingerprint(reservation);
+    for (const auto &event : events) {
+        if (!isItineraryEvent(event)) {
+            continue;
+        }
+        const auto &e = d->entry(event);
+        for (qsizetype i = 0; i < e.reservations.size(); ++i) {
+            if (MergeUtil::mayBeSame(e.fingerprints[i], fp) && MergeUtil::isSame(e.reservations[i], reservation)) {
+                results.push_back(event);
+            }
+        }
+    }
+    return results;
+}
+
+QList<QVariant> CalendarEventIndex::reservationsForEvent(const QSharedPointer<KCalendarCore::Event> &event)
+{
+    if (!event) {
+        return {};
+    }
+    return d->entry(event).reservations;
+}
+
+void CalendarEventIndex::clear()
+{
+    d->entries.clear();
+    d->numberIndex.clear();
+    d->numberIndexComplete = false;
+}
@@ -0,0 +1,64 @@
+/*
+   SPDX-FileCopyrightText: 2026 KItinerary contributors
+
+   SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "kitinerary_export.h"
+
+#include <QSharedPointer>
+
+#include <memory>
+
+template<typename T> class QList;
+class QVariant;
+
+namespace KCalendarCore {
+class Calendar;
+class Event;
+}
+
+namespace KItinerary {
+
+class CalendarEventIndexPrivate;
+
+/** Repeated lookup of calendar events for reservations.
+ *
+ *  This returns the same results as CalendarHandler::findEvents(), but is meant for
+ *  matching many reservations against the same calendar, e.g. when importing a large
+ *  trip history. The reservation data attached to each event is only decoded once and
+ *  cached by event UID and revision, and minimal cancellations are looked up via
+ *  their reservation number rather than by decoding half a year worth of events.
+ *
+ *  Changes to the calendar are picked up automatically for as long as both exist.
+ *
+ *  @since 26.12
+ */
+class KITINERARY_EXPORT CalendarEventIndex
+{
+public:
+    explicit CalendarEventIndex(KCalendarCore::Calendar *calendar);
+    ~CalendarEventIndex();
+    CalendarEventIndex(const CalendarEventIndex&) = delete;
+    CalendarEventIndex& operator=(const CalendarEventIndex&) = delete;
+
+    /** Attempts to find calendar events for @p reservation.
+     *  @see CalendarHandler::findEvents
+     */
+    [[nodiscard]] QList<QSharedPointer<KCalendarCore::Event>> findEvents(const QVariant &reservation);
+
+    /** Returns the reservations for @p event, decoded only on first access.
+     *  @see CalendarHandler::reservationsForEvent
+     */
+    [[nodiscard]] QList<QVariant> reservationsForEvent(const QSharedPointer<KCalendarCore::Event> &event);
+
+    /** Drops all cached data. */
+    void clear();
+
+private:
+    std::unique_ptr<CalendarEventIndexPrivate> d;
+};
+
+}
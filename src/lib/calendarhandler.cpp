@@ -6,6 +6,7 @@
 
 #include "config-kitinerary.h"
 #include "calendarhandler.h"
+#include "calendarhandler_p.h"
 #include "jsonlddocument.h"
 #include "locationutil_p.h"
 #include "logging.h"
@@ -71,34 +72,48 @@ QList<QSharedPointer<KCalendarCore::Event>> CalendarHandler::findEvents(
     return findEvents(calendar.data(), reservation);
 }
 
-QList<QSharedPointer<KCalendarCore::Event>>
-CalendarHandler::findEvents(KCalendarCore::Calendar *calendar,
-                            const QVariant &reservation) {
-    if (!(JsonLd::canConvert<Reservation>(reservation) || JsonLd::canConvert<KItinerary::Event>(reservation)) || !calendar) {
-        return {};
-    }
-
-    QList<KCalendarCore::Event::Ptr> events;
-    QList<KCalendarCore::Event::Ptr> results;
+CalendarHandler::SearchRange CalendarHandler::searchRange(const KCalendarCore::Calendar *calendar, const QVariant &reservation)
+{
     const auto startDt = SortUtil::startDateTime(reservation);
     const auto endDt = SortUtil::endDateTime(reservation);
     if (startDt.isValid() && endDt.isValid() && startDt == startDt.date().startOfDay(startDt.timeZone())
         && std::abs(endDt.secsTo(endDt.date().endOfDay(endDt.timeZone()))) <= 1) {
         // looks like an all day event, don't adjust for timezones in that case
-        events = calendar->events(startDt.date());
-    } else if (startDt.isValid()) {
+        return {startDt.date(), {}};
+    }
+    if (startDt.isValid()) {
         // we know the exact day to search at
-        events = calendar->events(startDt.toTimeZone(calendar->timeZone()).date());
-    } else if (JsonLd::canConvert<Reservation>(reservation)) {
+        return {startDt.toTimeZone(calendar->timeZone()).date(), {}};
+    }
+    if (JsonLd::canConvert<Reservation>(reservation)) {
         // for minimal cancellations, we need to search in a larger range
         const auto res = JsonLd::convert<Reservation>(reservation);
         if (!res.modifiedTime().isValid() || res.reservationStatus() != Reservation::ReservationCancelled) {
             return {};
         }
         const auto date = res.modifiedTime().toTimeZone(calendar->timeZone()).date();
-        events = calendar->events(date, date.addDays(180));
+        return {date, date.addDays(180)};
     }
+    return {};
+}
 
+QList<KCalendarCore::Event::Ptr> CalendarHandler::eventsInRange(KCalendarCore::Calendar *calendar, const SearchRange &range)
+{
+    if (!range.start.isValid()) {
+        return {};
+    }
+    return range.end.isValid() ? calendar->events(range.start, range.end) : calendar->events(range.start);
+}
+
+QList<QSharedPointer<KCalendarCore::Event>>
+CalendarHandler::findEvents(KCalendarCore::Calendar *calendar,
+                            const QVariant &reservation) {
+    if (!(JsonLd::canConvert<Reservation>(reservation) || JsonLd::canConvert<KItinerary::Event>(reservation)) || !calendar) {
+        return {};
+    }
+
+    QList<KCalendarCore::Event::Ptr> results;
+    const auto events = eventsInRange(calendar, searchRange(calendar, reservation));
     for (const auto &event : events) {
       if (!event->uid().startsWith(QLatin1StringView("KIT-"))) {
         continue;
@@ -26,6 +26,7 @@ namespace CalendarHandler
      *  For a complete reservation this should not return more than one element,
      *  for a minimal cancellation element however this can return multiple events
      *  (e.g. all trip segments covered by the same reservation number).
+     *  For matching many reservations against the same calendar, use CalendarEventIndex instead.
      *  @since 20.08
      */
 KITINERARY_EXPORT QList<QSharedPointer<KCalendarCore::Event>>
@@ -0,0 +1,39 @@
+/*
+    SPDX-FileCopyrightText: 2026 KItinerary contributors
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KITINERARY_CALENDARHANDLER_P_H
+#define KITINERARY_CALENDARHANDLER_P_H
+
+#include <QDate>
+#include <QSharedPointer>
+
+template<typename T> class QList;
+class QVariant;
+
+namespace KCalendarCore {
+class Calendar;
+class Event;
+}
+
+namespace KItinerary {
+
+namespace CalendarHandler {
+/** Days in which calendar events for a reservation are searched.
+ *  @c end is only set when searching more than a single day (minimal cancellations),
+ *  an invalid @c start means there is nothing to search for.
+ */
+struct SearchRange {
+    QDate start;
+    QDate end;
+};
+[[nodiscard]] SearchRange searchRange(const KCalendarCore::Calendar *calendar, const QVariant &reservation);
+
+/** All events of @p calendar in @p range. */
+[[nodiscard]] QList<QSharedPointer<KCalendarCore::Event>> eventsInRange(KCalendarCore::Calendar *calendar, const SearchRange &range);
+}
+
+}
+
+#endif
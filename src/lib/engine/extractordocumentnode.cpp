@@ -5,6 +5,7 @@
 */
 
 #include "extractordocumentnode.h"
+#include "extractordocumentnodearena_p.h"
 #include "extractordocumentprocessor.h"
 #include "extractorfilter.h"
 #include "extractorresult.h"
@@ -44,13 +45,21 @@ QJSEngine* ExtractorDocumentNodePrivate::jsEngine() const
     return p ? p->jsEngine() : nullptr;
 }
 
+[[nodiscard]] static std::shared_ptr<ExtractorDocumentNodePrivate> createNodePrivate()
+{
+    if (auto arena = ExtractorDocumentNodeArena::current()) {
+        return std::allocate_shared<ExtractorDocumentNodePrivate>(ExtractorDocumentNodeArena::Allocator<ExtractorDocumentNodePrivate>(arena));
+    }
+    return std::make_shared<ExtractorDocumentNodePrivate>();
+}
+
 ExtractorDocumentNode::ExtractorDocumentNode()
-    : d(std::make_shared<ExtractorDocumentNodePrivate>())
+    : d(createNodePrivate())
 {
 }
 
 ExtractorDocumentNode::ExtractorDocumentNode(const std::shared_ptr<ExtractorDocumentNodePrivate> &dd)
-    : d(dd ? dd : std::make_shared<ExtractorDocumentNodePrivate>())
+    : d(dd ? dd : createNodePrivate())
 {
 }
 
@@ -0,0 +1,30 @@
+/*
+    SPDX-FileCopyrightText: 2026 KItinerary contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "extractordocumentnodearena_p.h"
+
+using namespace KItinerary;
+
+static thread_local const std::shared_ptr<ExtractorDocumentNodeArena> *s_currentArena = nullptr;
+
+ExtractorDocumentNodeArena::ExtractorDocumentNodeArena() = default;
+ExtractorDocumentNodeArena::~ExtractorDocumentNodeArena() = default;
+
+std::shared_ptr<ExtractorDocumentNodeArena> ExtractorDocumentNodeArena::current()
+{
+    return s_currentArena ? *s_currentArena : std::shared_ptr<ExtractorDocumentNodeArena>();
+}
+
+ExtractorDocumentNodeArena::Scope::Scope(const std::shared_ptr<ExtractorDocumentNodeArena> &arena)
+    : m_previous(s_currentArena)
+{
+    s_currentArena = &arena;
+}
+
+ExtractorDocumentNodeArena::Scope::~Scope()
+{
+    s_currentArena = m_previous;
+}
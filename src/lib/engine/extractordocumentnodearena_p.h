@@ -0,0 +1,84 @@
+/*
+    SPDX-FileCopyrightText: 2026 KItinerary contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+namespace KItinerary {
+
+/** Memory arena for allocating document nodes during an extraction run.
+ *
+ *  Memory is never returned individually, only in bulk when the arena is destroyed.
+ *  Every allocation keeps the arena alive via its allocator, so node handles
+ *  outliving the extraction run remain valid.
+ *
+ *  Not thread-safe for allocation, this is meant to be used from the thread
+ *  running the ExtractorEngine owning it.
+ */
+class ExtractorDocumentNodeArena
+{
+public:
+    explicit ExtractorDocumentNodeArena();
+    ~ExtractorDocumentNodeArena();
+
+    /** Arena to allocate new nodes from on the current thread, if any. */
+    [[nodiscard]] static std::shared_ptr<ExtractorDocumentNodeArena> current();
+
+    /** Standard allocator for use with std::allocate_shared. */
+    template <typename T>
+    class Allocator
+    {
+    public:
+        using value_type = T;
+
+        inline explicit Allocator(const std::shared_ptr<ExtractorDocumentNodeArena> &arena)
+            : m_arena(arena)
+        {
+        }
+        template <typename U>
+        inline Allocator(const Allocator<U> &other)
+            : m_arena(other.m_arena)
+        {
+        }
+
+        [[nodiscard]] inline T* allocate(std::size_t n)
+        {
+            return static_cast<T*>(m_arena->m_resource.allocate(n * sizeof(T), alignof(T)));
+        }
+        inline void deallocate(T*, std::size_t) {} // released in bulk
+
+        template <typename U>
+        inline bool operator==(const Allocator<U> &other) const
+        {
+            return m_arena == other.m_arena;
+        }
+
+    private:
+        template <typename U> friend class Allocator;
+        std::shared_ptr<ExtractorDocumentNodeArena> m_arena;
+    };
+
+    /** Makes @p arena the current arena for the lifetime of this object. */
+    class Scope
+    {
+    public:
+        explicit Scope(const std::shared_ptr<ExtractorDocumentNodeArena> &arena);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const std::shared_ptr<ExtractorDocumentNodeArena> *m_previous;
+    };
+
+private:
+    std::pmr::monotonic_buffer_resource m_resource;
+};
+
+}
@@ -7,6 +7,7 @@
 #include "extractordocumentnodefactory.h"
 #include "extractordocumentnode.h"
 #include "extractordocumentprocessor.h"
+#include "extractorstatistics_p.h"
 #include "logging.h"
 
 #include "processors/binarydocumentprocessor.h"
@@ -72,6 +73,9 @@ public:
 
 class ExtractorDocumentNodeFactoryPrivate {
 public:
+    [[nodiscard]] ExtractorDocumentNode createNode(const QByteArray &data, QStringView fileName, QStringView mimeType) const;
+    [[nodiscard]] ExtractorDocumentNode createNode(const QVariant &decodedData, QStringView mimeType) const;
+
     ExtractorDocumentNodeFactoryStatic *s;
     std::unique_ptr<ExtractorDocumentProcessor> interceptProcessor;
 };
@@ -160,18 +164,18 @@ ExtractorDocumentNodeFactory::ExtractorDocumentNodeFactory()
 
 ExtractorDocumentNodeFactory::~ExtractorDocumentNodeFactory() = default;
 
-ExtractorDocumentNode ExtractorDocumentNodeFactory::createNode(const QByteArray &data, QStringView fileName, QStringView mimeType) const
+ExtractorDocumentNode ExtractorDocumentNodeFactoryPrivate::createNode(const QByteArray &data, QStringView fileName, QStringView mimeType) const
 {
     if (data.size() <= MinDocumentSize || data.size() > MaxDocumentSize) {
         return {};
     }
 
-    if (d->interceptProcessor && d->interceptProcessor->canHandleData(data, fileName)) {
-        auto node = d->interceptProcessor->createNodeFromData(data);
+    if (interceptProcessor && interceptProcessor->canHandleData(data, fileName)) {
+        auto node = interceptProcessor->createNodeFromData(data);
         if (node.mimeType().isEmpty()) {
             node.setMimeType(QStringLiteral("internal/external-process"));
         }
-        node.setProcessor(d->interceptProcessor.get());
+        node.setProcessor(interceptProcessor.get());
         return node;
     }
 
@@ -183,10 +187,10 @@ ExtractorDocumentNode ExtractorDocumentNodeFactory::createNode(const QByteArray
         } else {
             autoDetectedMimeType = db.mimeTypeForFileNameAndData(fileName.toString(), data).name();
         }
-        mimeType = d->s->resolveAlias(autoDetectedMimeType);
+        mimeType = s->resolveAlias(autoDetectedMimeType);
 
         // let processors check themselves if they support this data, or whether the auto-detected mimetype matches
-        for (const auto &p : d->s->m_probeProcessors) {
+        for (const auto &p : s->m_probeProcessors) {
             if (p.processor->canHandleData(data, fileName) || (!mimeType.isEmpty() && p.mimeType == mimeType)) {
                 auto node = p.processor->createNodeFromData(data);
                 if (node.content().isNull()) {
@@ -200,7 +204,7 @@ ExtractorDocumentNode ExtractorDocumentNodeFactory::createNode(const QByteArray
         }
 
         // try the basic types that ultimately will accept anything
-        for (const auto &p : d->s->m_fallbackProbeProcessors) {
+        for (const auto &p : s->m_fallbackProbeProcessors) {
             if (p.processor->canHandleData(data, fileName)) {
                 auto node = p.processor->createNodeFromData(data);
                 if (node.content().isNull()) {
@@ -217,11 +221,11 @@ ExtractorDocumentNode ExtractorDocumentNodeFactory::createNode(const QByteArray
         return {};
     }
 
-    mimeType = d->s->resolveAlias(mimeType);
-    const auto it = std::lower_bound(d->s->m_mimetypeProcessorMap.begin(), d->s->m_mimetypeProcessorMap.end(), mimeType, [](const auto &proc, auto mt) {
+    mimeType = s->resolveAlias(mimeType);
+    const auto it = std::lower_bound(s->m_mimetypeProcessorMap.begin(), s->m_mimetypeProcessorMap.end(), mimeType, [](const auto &proc, auto mt) {
         return proc.mimeType < mt;
     });
-    if (it == d->s->m_mimetypeProcessorMap.end() || (*it).mimeType != mimeType) {
+    if (it == s->m_mimetypeProcessorMap.end() || (*it).mimeType != mimeType) {
         qCDebug(Log) << "No document processor found for mimetype" << mimeType;
         return {};
     }
@@ -232,13 +236,13 @@ ExtractorDocumentNode ExtractorDocumentNodeFactory::createNode(const QByteArray
     return node;
 }
 
-ExtractorDocumentNode ExtractorDocumentNodeFactory::createNode(const QVariant &decodedData, QStringView mimeType) const
+ExtractorDocumentNode ExtractorDocumentNodeFactoryPrivate::createNode(const QVariant &decodedData, QStringView mimeType) const
 {
-    mimeType = d->s->resolveAlias(mimeType);
-    const auto it = std::lower_bound(d->s->m_mimetypeProcessorMap.begin(), d->s->m_mimetypeProcessorMap.end(), mimeType, [](const auto &proc, auto mt) {
+    mimeType = s->resolveAlias(mimeType);
+    const auto it = std::lower_bound(s->m_mimetypeProcessorMap.begin(), s->m_mimetypeProcessorMap.end(), mimeType, [](const auto &proc, auto mt) {
         return proc.mimeType < mt;
     });
-    if (it == d->s->m_mimetypeProcessorMap.end() || (*it).mimeType != mimeType) {
+    if (it == s->m_mimetypeProcessorMap.end() || (*it).mimeType != mimeType) {
         qCDebug(Log) << "No document processor found for mimetype" << mimeType;
         return {};
     }
@@ -249,6 +253,22 @@ ExtractorDocumentNode ExtractorDocumentNodeFactory::createNode(const QVariant &d
     return node;
 }
 
+ExtractorDocumentNode ExtractorDocumentNodeFactory::createNode(const QByteArray &data, QStringView fileName, QStringView mimeType) const
+{
+    ExtractorStatistics::Timer timer(ExtractorStatistics::current(), ExtractorStatistics::CreateNode);
+    auto node = d->createNode(data, fileName, mimeType);
+    timer.stop(node.mimeType());
+    return node;
+}
+
+ExtractorDocumentNode ExtractorDocumentNodeFactory::createNode(const QVariant &decodedData, QStringView mimeType) const
+{
+    ExtractorStatistics::Timer timer(ExtractorStatistics::current(), ExtractorStatistics::CreateNode);
+    auto node = d->createNode(decodedData, mimeType);
+    timer.stop(node.mimeType());
+    return node;
+}
+
 void ExtractorDocumentNodeFactory::registerProcessor(std::unique_ptr<ExtractorDocumentProcessor> &&processor, QStringView mimeType,
                                                      std::initializer_list<QStringView> aliasMimeTypes)
 {
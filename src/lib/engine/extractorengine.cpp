@@ -10,32 +10,81 @@
 #include "barcodedecoder.h"
 #include "abstractextractor.h"
 #include "extractordocumentnode.h"
+#include "extractordocumentnodearena_p.h"
 #include "extractordocumentnodefactory.h"
 #include "extractordocumentprocessor.h"
 #include "extractorresult.h"
+#include "extractorresultcache_p.h"
 #include "extractorrepository.h"
 #include "extractorscriptengine_p.h"
+#include "extractorstatistics_p.h"
 #include "jsonlddocument.h"
 #include "logging.h"
+#include "pdf/pdfdocument.h"
+#include "pdf/pdfdocument_p.h"
 
+#include <QCryptographicHash>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
+#include <QImage>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QLocale>
+#include <QSet>
 
+#include <algorithm>
+#include <array>
 #include <cstring>
 
+using namespace Qt::Literals::StringLiterals;
 using namespace KItinerary;
 
 namespace KItinerary {
 
+constexpr inline std::size_t MemoryCategoryCount = ExtractorEngine::BarcodeCacheMemory + 1;
+using MemoryUsageArray = std::array<qint64, MemoryCategoryCount>;
+
+/** Approximate memory held by a set of document nodes.
+ *  Images and PDF documents shared between nodes are only counted once.
+ */
+class NodeMemoryUsage {
+public:
+    void addNode(const ExtractorDocumentNode &node);
+    void addSubtree(const ExtractorDocumentNode &node);
+    void removeImage(const QImage &img);
+    void clear();
+
+    qint64 nodeMemory = 0;
+    qint64 imageMemory = 0;
+    QSet<qint64> images;
+    std::vector<PdfDocument*> pdfs;
+};
+
 class ExtractorEnginePrivate {
 public:
     void processNode(ExtractorDocumentNode &node);
 
+    void resetBudget();
+    [[nodiscard]] bool checkTimeBudget();
+    [[nodiscard]] bool consumeBudget(qint64 &used, qint64 amount, qint64 budget, ExtractorEngine::BudgetExhaustion reason);
+    void setBudgetExhausted(ExtractorEngine::BudgetExhaustion reason);
+
+    [[nodiscard]] QByteArray resultCacheKey() const;
+    [[nodiscard]] QJsonArray toCachedResult(QJsonArray result) const;
+    void fromCachedResult(QJsonArray &result) const;
+    void createPendingRootNode();
+
+    [[nodiscard]] MemoryUsageArray memoryUsage(const NodeMemoryUsage &nodeUsage) const;
+    [[nodiscard]] MemoryUsageArray currentMemoryUsage() const;
+    [[nodiscard]] bool hasMemoryAccounting() const;
+    MemoryUsageArray updateMemoryUsage();
+    void pruneImages(ExtractorDocumentNode &node);
+
+    void updateStatistics(void (ExtractorStatistics::*setter)(bool), bool enable);
+
     ExtractorEngine *q = nullptr;
     std::vector<const AbstractExtractor*> m_additionalExtractors;
     ExtractorDocumentNode m_rootNode;
@@ -45,41 +94,351 @@ public:
     BarcodeDecoder m_barcodeDecoder;
     ExtractorScriptEngine m_scriptEngine;
     ExtractorEngine::Hints m_hints = ExtractorEngine::NoHint;
+    std::shared_ptr<ExtractorDocumentNodeArena> m_nodeArena;
+
+    std::chrono::milliseconds m_timeBudget = {};
+    qint64 m_nodeBudget = 0;
+    qint64 m_scriptBudget = 0;
+    qint64 m_pixelBudget = 0;
+    QElapsedTimer m_budgetTimer;
+    qint64 m_nodeCount = 0;
+    qint64 m_scriptCount = 0;
+    qint64 m_pixelCount = 0;
+    ExtractorEngine::BudgetExhaustion m_budgetExhaustion = ExtractorEngine::BudgetNotExhausted;
+
+    std::unique_ptr<ExtractorResultCache> m_resultCache;
+    QByteArray m_repoFingerprint;
+    // with a result cache, raw input data is only parsed once we know we need to
+    QByteArray m_pendingData;
+    QString m_pendingFileName;
+    QString m_pendingMimeType;
+    bool m_hasPendingData = false;
+    QString m_cachedUsedExtractor;
+
+    std::unique_ptr<ExtractorStatistics> m_statistics;
+
+    bool m_memoryAccounting = false;
+    // updated for every expanded node during extract(), rather than walking the entire tree each time
+    NodeMemoryUsage m_nodeMemoryUsage;
+    MemoryUsageArray m_memoryPeak = {};
+    MemoryUsageArray m_memoryLimit = {};
 };
 
 }
 
-void ExtractorEnginePrivate::processNode(ExtractorDocumentNode& node)
+void ExtractorEnginePrivate::resetBudget()
+{
+    m_budgetTimer.invalidate();
+    m_nodeCount = 0;
+    m_scriptCount = 0;
+    m_pixelCount = 0;
+    m_budgetExhaustion = ExtractorEngine::BudgetNotExhausted;
+}
+
+bool ExtractorEnginePrivate::checkTimeBudget()
+{
+    if (m_budgetExhaustion != ExtractorEngine::BudgetNotExhausted) {
+        return false;
+    }
+    if (m_timeBudget.count() > 0 && m_budgetTimer.isValid() && m_budgetTimer.hasExpired(m_timeBudget.count())) {
+        setBudgetExhausted(ExtractorEngine::TimeBudgetExhausted);
+        return false;
+    }
+    return true;
+}
+
+bool ExtractorEnginePrivate::consumeBudget(qint64 &used, qint64 amount, qint64 budget, ExtractorEngine::BudgetExhaustion reason)
+{
+    if (!checkTimeBudget()) {
+        return false;
+    }
+    used += amount;
+    if (budget > 0 && used > budget) {
+        setBudgetExhausted(reason);
+        return false;
+    }
+    return true;
+}
+
+void ExtractorEnginePrivate::setBudgetExhausted(ExtractorEngine::BudgetExhaustion reason)
+{
+    qCDebug(Log) << "Extraction budget exhausted:" << reason << m_budgetTimer.elapsed() << "ms" << m_nodeCount << "nodes" << m_scriptCount << "scripts" << m_pixelCount << "pixels";
+    m_budgetExhaustion = reason;
+}
+
+QByteArray ExtractorEnginePrivate::resultCacheKey() const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    const auto addField = [&hash](QByteArrayView data) {
+        hash.addData(data);
+        hash.addData(QByteArrayView("\0", 1));
+    };
+    addField(m_repoFingerprint);
+    addField(QByteArray::number(m_hints.toInt()));
+    for (const auto ext : m_additionalExtractors) {
+        addField(ext ? ext->name().toUtf8() : QByteArray());
+    }
+    // only the day matters for interpreting incomplete dates, and keying on the exact time
+    // would make this useless for callers defaulting the context to the current time
+    addField(m_contextNode.contextDateTime().date().toString(Qt::ISODate).toUtf8());
+    // the file name is only used for MIME type detection, the location of the file doesn't matter
+    addField(QFileInfo(m_pendingFileName).suffix().toLower().toUtf8());
+    addField(m_pendingMimeType.toUtf8());
+    hash.addData(m_pendingData);
+    return hash.result();
+}
+
+// modification times defaulted to the context time differ between otherwise identical runs
+// on the same day, so those are stored without and added back from the current context on a cache hit
+QJsonArray ExtractorEnginePrivate::toCachedResult(QJsonArray result) const
+{
+    const auto contextDt = m_contextNode.contextDateTime();
+    if (!contextDt.isValid()) {
+        return result;
+    }
+    const auto modifiedTime = contextDt.toString(Qt::ISODate);
+    for (qsizetype i = 0; i < result.size(); ++i) {
+        auto res = result.at(i).toObject();
+        if (res.value(QLatin1StringView("modifiedTime")).toString() == modifiedTime) {
+            res.remove(QLatin1StringView("modifiedTime"));
+            result[i] = res;
+        }
+    }
+    return result;
+}
+
+void ExtractorEnginePrivate::fromCachedResult(QJsonArray &result) const
+{
+    const auto contextDt = m_contextNode.contextDateTime();
+    if (!contextDt.isValid()) {
+        return;
+    }
+    for (qsizetype i = 0; i < result.size(); ++i) {
+        auto res = result.at(i).toObject();
+        if (!res.contains(QLatin1StringView("modifiedTime"))) {
+            res.insert(QStringLiteral("modifiedTime"), contextDt.toString(Qt::ISODate));
+            result[i] = res;
+        }
+    }
+}
+
+void ExtractorEnginePrivate::createPendingRootNode()
+{
+    if (!m_hasPendingData) {
+        return;
+    }
+    m_rootNode = m_nodeFactory.createNode(m_pendingData, m_pendingFileName, m_pendingMimeType);
+    m_pendingData.clear();
+    m_hasPendingData = false;
+}
+
+// rough estimate of the per-node overhead, ie. the node data, processor state and results
+constexpr inline qint64 NodeMemoryOverhead = 256;
+
+void NodeMemoryUsage::addNode(const ExtractorDocumentNode &node)
 {
     if (node.isNull()) {
         return;
     }
+    nodeMemory += NodeMemoryOverhead;
+
+    const auto content = node.content();
+    switch (content.typeId()) {
+        case QMetaType::QByteArray:
+            nodeMemory += content.toByteArray().size();
+            break;
+        case QMetaType::QString:
+            nodeMemory += content.toString().size() * sizeof(QChar);
+            break;
+        case QMetaType::QImage:
+        {
+            // images are implicitly shared, so only count each one once
+            const auto img = content.value<QImage>();
+            if (!images.contains(img.cacheKey())) {
+                images.insert(img.cacheKey());
+                imageMemory += img.sizeInBytes();
+            }
+            break;
+        }
+        default:
+            if (const auto pdf = node.content<PdfDocument*>(); pdf && std::find(pdfs.begin(), pdfs.end(), pdf) == pdfs.end()) {
+                pdfs.push_back(pdf);
+                nodeMemory += pdf->fileSize();
+            }
+            break;
+    }
+}
+
+void NodeMemoryUsage::addSubtree(const ExtractorDocumentNode &node)
+{
+    addNode(node);
+    for (const auto &child : node.childNodes()) {
+        addSubtree(child);
+    }
+}
+
+void NodeMemoryUsage::removeImage(const QImage &img)
+{
+    if (images.remove(img.cacheKey())) {
+        imageMemory -= img.sizeInBytes();
+    }
+}
+
+void NodeMemoryUsage::clear()
+{
+    nodeMemory = 0;
+    imageMemory = 0;
+    images.clear();
+    pdfs.clear();
+}
+
+MemoryUsageArray ExtractorEnginePrivate::memoryUsage(const NodeMemoryUsage &nodeUsage) const
+{
+    MemoryUsageArray usage = {};
+    usage[ExtractorEngine::DocumentNodeMemory] = nodeUsage.nodeMemory + m_pendingData.size();
+    usage[ExtractorEngine::ImageMemory] = nodeUsage.imageMemory;
+    for (const auto pdf : nodeUsage.pdfs) {
+        usage[ExtractorEngine::PdfImageCacheMemory] += PdfDocumentPrivate::get(pdf)->imageCacheSize();
+    }
+    usage[ExtractorEngine::BarcodeCacheMemory] = m_barcodeDecoder.cacheMemoryUsage();
+    return usage;
+}
+
+MemoryUsageArray ExtractorEnginePrivate::currentMemoryUsage() const
+{
+    NodeMemoryUsage nodeUsage;
+    nodeUsage.addSubtree(m_contextNode);
+    nodeUsage.addSubtree(m_rootNode);
+    return memoryUsage(nodeUsage);
+}
+
+bool ExtractorEnginePrivate::hasMemoryAccounting() const
+{
+    return m_memoryAccounting || std::any_of(m_memoryLimit.begin(), m_memoryLimit.end(), [](auto limit) { return limit > 0; });
+}
+
+MemoryUsageArray ExtractorEnginePrivate::updateMemoryUsage()
+{
+    const auto usage = memoryUsage(m_nodeMemoryUsage);
+    for (std::size_t i = 0; i < MemoryCategoryCount; ++i) {
+        m_memoryPeak[i] = std::max(m_memoryPeak[i], usage[i]);
+    }
+
+    const auto exceedsLimit = [&usage, this](ExtractorEngine::MemoryCategory category) {
+        return m_memoryLimit[category] > 0 && usage[category] > m_memoryLimit[category];
+    };
+    if (exceedsLimit(ExtractorEngine::BarcodeCacheMemory)) {
+        qCDebug(Log) << "Barcode cache exceeds memory limit:" << usage[ExtractorEngine::BarcodeCacheMemory];
+        m_barcodeDecoder.clearCache();
+    }
+    if (exceedsLimit(ExtractorEngine::PdfImageCacheMemory)) {
+        qCDebug(Log) << "PDF image caches exceed memory limit:" << usage[ExtractorEngine::PdfImageCacheMemory];
+        for (const auto pdf : m_nodeMemoryUsage.pdfs) {
+            PdfDocumentPrivate::get(pdf)->clearImageCache();
+        }
+    }
+    return usage;
+}
+
+void ExtractorEnginePrivate::pruneImages(ExtractorDocumentNode &node)
+{
+    if (node.content().typeId() == QMetaType::QImage) {
+        m_nodeMemoryUsage.removeImage(node.content<QImage>());
+        node.setContent(QImage());
+    }
+    for (auto child : node.childNodes()) {
+        pruneImages(child);
+    }
+}
+
+// relative processing cost of a document node, so that cheap structured data sources
+// get processed before expensive ones in case we run out of budget
+[[nodiscard]] static int processingCost(const ExtractorDocumentNode &node)
+{
+    const auto mimeType = node.mimeType();
+    // rendering, image decoding and barcode detection
+    if (mimeType == "application/pdf"_L1 || mimeType == "internal/qimage"_L1) {
+        return 2;
+    }
+    // unstructured content, usually triggering many generic script extractors
+    if (mimeType == "text/plain"_L1 || mimeType == "text/html"_L1 || mimeType == "message/rfc822"_L1) {
+        return 1;
+    }
+    // structured content such as JSON-LD, decoded barcodes or calendar data
+    return 0;
+}
 
+void ExtractorEnginePrivate::processNode(ExtractorDocumentNode& node)
+{
+    if (node.isNull() || !consumeBudget(m_nodeCount, 1, m_nodeBudget, ExtractorEngine::NodeBudgetExhausted)) {
+        return;
+    }
+
+    const auto memoryAccounting = hasMemoryAccounting();
+    const auto previousChildCount = memoryAccounting ? node.childNodes().size() : 0;
+
+    const auto stats = m_statistics.get();
+    ExtractorStatistics::Timer expandTimer(stats, ExtractorStatistics::ExpandNode);
     node.processor()->expandNode(node, q);
-    for (auto c : node.childNodes()) {
+    expandTimer.stop(node.mimeType());
+
+    auto childNodes = node.childNodes();
+    if (memoryAccounting && childNodes.size() > previousChildCount) {
+        // only account for newly created nodes, everything else has been counted already
+        for (auto it = childNodes.begin() + previousChildCount; it != childNodes.end(); ++it) {
+            m_nodeMemoryUsage.addSubtree(*it);
+        }
+        updateMemoryUsage();
+    }
+
+    // this only changes the processing order, results are still reduced in document order
+    std::stable_sort(childNodes.begin(), childNodes.end(), [](const auto &lhs, const auto &rhs) {
+        return processingCost(lhs) < processingCost(rhs);
+    });
+    for (auto &c : childNodes) {
         processNode(c);
+        if (memoryAccounting) {
+            const auto usage = updateMemoryUsage();
+            // images of fully processed nodes are only needed for tooling at this point
+            const auto imageLimit = m_memoryLimit[ExtractorEngine::ImageMemory];
+            if (imageLimit > 0 && usage[ExtractorEngine::ImageMemory] > imageLimit) {
+                pruneImages(c);
+            }
+        }
     }
     node.processor()->reduceNode(node);
 
+    ExtractorStatistics::Timer preExtractTimer(stats, ExtractorStatistics::PreExtract);
     node.processor()->preExtract(node, q);
+    preExtractTimer.stop(node.mimeType());
+
+    ExtractorStatistics::Timer extractTimer(stats, ExtractorStatistics::Extract);
     std::vector<const AbstractExtractor*> extractors = m_additionalExtractors;
     m_repo.extractorsForNode(node, extractors);
 
     ExtractorResult nodeResult;
     QString usedExtractor;
     for (const auto &extractor : extractors) {
+        if (!checkTimeBudget()) {
+            break;
+        }
+        ExtractorStatistics::Timer runTimer(stats, ExtractorStatistics::RunExtractor);
         auto res = extractor->extract(node, q);
+        runTimer.stop(extractor->name(), !res.isEmpty());
         if (!res.isEmpty()) {
             usedExtractor = extractor->name();
             nodeResult.append(std::move(res));
         }
     }
+    extractTimer.stop(node.mimeType(), !nodeResult.isEmpty());
     if (!nodeResult.isEmpty()) {
         node.setResult(std::move(nodeResult));
         node.setUsedExtractor(usedExtractor);
     }
 
+    ExtractorStatistics::Timer postExtractTimer(stats, ExtractorStatistics::PostExtract);
     node.processor()->postExtract(node, q);
+    postExtractTimer.stop(node.mimeType());
 
     // set modification time for all results that don't have it yet
     if (node.contextDateTime().isValid()) {
@@ -115,20 +474,48 @@ void ExtractorEngine::clear()
 {
     d->m_rootNode = {};
     d->m_contextNode = {};
+    d->m_pendingData.clear();
+    d->m_hasPendingData = false;
+    d->m_cachedUsedExtractor.clear();
+    d->m_nodeMemoryUsage.clear();
+    d->resetBudget();
+
+    // nodes still referenced elsewhere (e.g. by scripts) keep the old arena alive
+    // until they are gone, its memory is released together with the last one
+    if (d->m_nodeArena) {
+        d->m_nodeArena = std::make_shared<ExtractorDocumentNodeArena>();
+    }
 }
 
 void ExtractorEngine::setData(const QByteArray &data, QStringView fileName, QStringView mimeType)
 {
+    if (d->m_resultCache) {
+        d->m_rootNode = {};
+        d->m_pendingData = data;
+        d->m_pendingFileName = fileName.toString();
+        d->m_pendingMimeType = mimeType.toString();
+        d->m_hasPendingData = true;
+        return;
+    }
+
+    ExtractorDocumentNodeArena::Scope arenaScope(d->m_nodeArena);
+    ExtractorStatistics::Scope statisticsScope(d->m_statistics.get());
     d->m_rootNode = d->m_nodeFactory.createNode(data, fileName, mimeType);
 }
 
 void ExtractorEngine::setContent(const QVariant &data, QStringView mimeType)
 {
+    d->m_pendingData.clear();
+    d->m_hasPendingData = false;
+    ExtractorDocumentNodeArena::Scope arenaScope(d->m_nodeArena);
+    ExtractorStatistics::Scope statisticsScope(d->m_statistics.get());
     d->m_rootNode = d->m_nodeFactory.createNode(data, mimeType);
 }
 
 void ExtractorEngine::setContext(const QVariant &data, QStringView mimeType)
 {
+    ExtractorDocumentNodeArena::Scope arenaScope(d->m_nodeArena);
+    ExtractorStatistics::Scope statisticsScope(d->m_statistics.get());
     d->m_contextNode = d->m_nodeFactory.createNode(data, mimeType);
 }
 
@@ -147,11 +534,87 @@ void ExtractorEngine::setHints(ExtractorEngine::Hints hints)
     d->m_hints = hints;
 }
 
+void ExtractorEngine::setTimeBudget(std::chrono::milliseconds time)
+{
+    d->m_timeBudget = time;
+}
+
+void ExtractorEngine::setNodeBudget(qint64 nodeCount)
+{
+    d->m_nodeBudget = nodeCount;
+}
+
+void ExtractorEngine::setScriptBudget(qint64 scriptCount)
+{
+    d->m_scriptBudget = scriptCount;
+}
+
+void ExtractorEngine::setPixelBudget(qint64 pixelCount)
+{
+    d->m_pixelBudget = pixelCount;
+}
+
+ExtractorEngine::BudgetExhaustion ExtractorEngine::budgetExhaustion() const
+{
+    return d->m_budgetExhaustion;
+}
+
 QJsonArray ExtractorEngine::extract()
 {
+    ExtractorDocumentNodeArena::Scope arenaScope(d->m_nodeArena);
+    ExtractorStatistics::Scope statisticsScope(d->m_statistics.get());
+    d->resetBudget();
+    d->m_budgetTimer.start();
+    d->m_cachedUsedExtractor.clear();
+    d->m_memoryPeak = {};
+
+    QByteArray cacheKey;
+    if (d->m_hasPendingData) {
+        // arbitrary context documents can't be reliably fingerprinted
+        if (d->m_contextNode.content().isNull()) {
+            cacheKey = d->resultCacheKey();
+            QJsonArray result;
+            if (d->m_resultCache->lookup(cacheKey, result, d->m_cachedUsedExtractor)) {
+                d->fromCachedResult(result);
+                d->m_pendingData.clear();
+                d->m_hasPendingData = false;
+                return result;
+            }
+        }
+        d->createPendingRootNode();
+    }
+
     d->m_rootNode.setParent(d->m_contextNode);
+    d->m_nodeMemoryUsage.clear();
+    if (d->hasMemoryAccounting()) {
+        d->m_nodeMemoryUsage.addSubtree(d->m_contextNode);
+        d->m_nodeMemoryUsage.addSubtree(d->m_rootNode);
+        d->updateMemoryUsage();
+    }
     d->processNode(d->m_rootNode);
-    return d->m_rootNode.result().jsonLdResult();
+    if (d->hasMemoryAccounting()) {
+        d->updateMemoryUsage();
+    }
+    const auto result = d->m_rootNode.result().jsonLdResult();
+
+    // results from incomplete runs depend on timing and configured budgets
+    if (!cacheKey.isEmpty() && d->m_budgetExhaustion == BudgetNotExhausted) {
+        d->m_resultCache->insert(cacheKey, d->toCachedResult(result), d->m_rootNode.usedExtractor());
+    }
+    return result;
+}
+
+void ExtractorEngine::setResultCache(const QString &path, qint64 maxSize)
+{
+    if (path.isEmpty()) {
+        ExtractorDocumentNodeArena::Scope arenaScope(d->m_nodeArena);
+        ExtractorStatistics::Scope statisticsScope(d->m_statistics.get());
+        d->createPendingRootNode();
+        d->m_resultCache.reset();
+        return;
+    }
+    d->m_resultCache = std::make_unique<ExtractorResultCache>(path, maxSize);
+    d->m_repoFingerprint = ExtractorResultCache::repositoryFingerprint(d->m_repo);
 }
 
 void ExtractorEngine::setUseSeparateProcess(bool separateProcess)
@@ -159,13 +622,94 @@ void ExtractorEngine::setUseSeparateProcess(bool separateProcess)
     d->m_nodeFactory.setUseSeparateProcess(separateProcess);
 }
 
+void ExtractorEngine::setUseNodeArena(bool useArena)
+{
+    if (useArena && !d->m_nodeArena) {
+        d->m_nodeArena = std::make_shared<ExtractorDocumentNodeArena>();
+    } else if (!useArena) {
+        d->m_nodeArena.reset();
+    }
+}
+
 void ExtractorEngine::setAdditionalExtractors(std::vector<const AbstractExtractor*> &&extractors)
 {
     d->m_additionalExtractors = std::move(extractors);
 }
 
+void ExtractorEnginePrivate::updateStatistics(void (ExtractorStatistics::*setter)(bool), bool enable)
+{
+    if (enable && !m_statistics) {
+        m_statistics = std::make_unique<ExtractorStatistics>();
+    }
+    if (m_statistics) {
+        (m_statistics.get()->*setter)(enable);
+        if (!m_statistics->isEnabled()) {
+            m_statistics.reset();
+        }
+    }
+}
+
+void ExtractorEngine::setCollectStatistics(bool collect)
+{
+    d->updateStatistics(&ExtractorStatistics::setCollectStatistics, collect);
+}
+
+std::vector<ExtractorEngine::StatisticsEntry> ExtractorEngine::statistics() const
+{
+    return d->m_statistics ? d->m_statistics->entries() : std::vector<StatisticsEntry>();
+}
+
+void ExtractorEngine::resetStatistics()
+{
+    if (d->m_statistics) {
+        d->m_statistics->clear();
+    }
+}
+
+void ExtractorEngine::setRecordTrace(bool record)
+{
+    d->updateStatistics(&ExtractorStatistics::setRecordTrace, record);
+}
+
+QJsonArray ExtractorEngine::traceEvents() const
+{
+    return d->m_statistics ? d->m_statistics->traceEvents() : QJsonArray();
+}
+
+void ExtractorEngine::resetTrace()
+{
+    if (d->m_statistics) {
+        d->m_statistics->clearTrace();
+    }
+}
+
+void ExtractorEngine::setMemoryAccounting(bool enable)
+{
+    d->m_memoryAccounting = enable;
+}
+
+ExtractorEngine::MemoryUsage ExtractorEngine::memoryUsage(MemoryCategory category) const
+{
+    MemoryUsage usage;
+    usage.current = d->currentMemoryUsage()[category];
+    usage.peak = d->m_memoryPeak[category];
+    return usage;
+}
+
+void ExtractorEngine::setMemorySoftLimit(MemoryCategory category, qint64 bytes)
+{
+    if (category == DocumentNodeMemory) {
+        qCWarning(Log) << "Document node memory cannot be limited, ignoring soft limit" << bytes;
+        return;
+    }
+    d->m_memoryLimit[category] = bytes;
+}
+
 QString ExtractorEngine::usedCustomExtractor() const
 {
+    if (!d->m_cachedUsedExtractor.isEmpty()) {
+        return d->m_cachedUsedExtractor;
+    }
     return d->m_rootNode.usedExtractor();
 }
 
@@ -192,10 +736,30 @@ const ExtractorScriptEngine* ExtractorEngine::scriptEngine() const
 
 ExtractorDocumentNode ExtractorEngine::rootDocumentNode() const
 {
+    ExtractorDocumentNodeArena::Scope arenaScope(d->m_nodeArena);
+    ExtractorStatistics::Scope statisticsScope(d->m_statistics.get());
+    d->createPendingRootNode();
     return d->m_rootNode;
 }
 
 void ExtractorEngine::processNode(ExtractorDocumentNode &node) const
 {
+    ExtractorDocumentNodeArena::Scope arenaScope(d->m_nodeArena);
+    ExtractorStatistics::Scope statisticsScope(d->m_statistics.get());
     d->processNode(node);
 }
+
+bool ExtractorEngine::checkTimeBudget() const
+{
+    return d->checkTimeBudget();
+}
+
+bool ExtractorEngine::consumeScriptBudget() const
+{
+    return d->consumeBudget(d->m_scriptCount, 1, d->m_scriptBudget, ScriptBudgetExhausted);
+}
+
+bool ExtractorEngine::consumePixelBudget(qint64 pixels) const
+{
+    return d->consumeBudget(d->m_pixelCount, pixels, d->m_pixelBudget, PixelBudgetExhausted);
+}
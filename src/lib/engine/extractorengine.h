@@ -10,6 +10,7 @@
 
 #include <QString>
 
+#include <chrono>
 #include <memory>
 #include <vector>
 
@@ -150,6 +151,16 @@ public:
      */
     void setUseSeparateProcess(bool separateProcess);
 
+    /** Allocate document nodes from a memory arena owned by this engine.
+     *  This reduces the allocation overhead for large document trees, memory
+     *  is then released in bulk. clear() starts a new arena, node handles remain
+     *  valid beyond that, and the memory of the previous arena is released once
+     *  the last one of its nodes is gone.
+     *  This is off by default.
+     *  @since 26.12
+     */
+    void setUseNodeArena(bool useArena);
+
     /** Sets additional extractors to run on the given data.
      *  Extractors are usually automatically selected, this is therefore most likely not needed to
      *  be called manually. This mainly exists for the external extractor process.
@@ -171,11 +182,166 @@ public:
     /** Set extraction hints. */
     void setHints(Hints hints);
 
+    /** Maximum wall-clock time for a single extract() call.
+     *  Once this or any of the other budgets is exhausted, extraction stops
+     *  cooperatively and the results found until then are returned.
+     *  Use budgetExhaustion() to check whether that happened.
+     *  A value of 0 means unlimited, which is the default for all budgets.
+     *  @since 26.12
+     */
+    void setTimeBudget(std::chrono::milliseconds time);
+    /** Maximum amount of document nodes to process in a single extract() call.
+     *  @see setTimeBudget()
+     *  @since 26.12
+     */
+    void setNodeBudget(qint64 nodeCount);
+    /** Maximum amount of extractor script invocations in a single extract() call.
+     *  @see setTimeBudget()
+     *  @since 26.12
+     */
+    void setScriptBudget(qint64 scriptCount);
+    /** Maximum amount of image pixels to analyze for barcodes in a single extract() call.
+     *  @see setTimeBudget()
+     *  @since 26.12
+     */
+    void setPixelBudget(qint64 pixelCount);
+
+    /** Reason why the last extract() call stopped early, if it did.
+     *  @since 26.12
+     */
+    enum BudgetExhaustion {
+        BudgetNotExhausted, ///< extraction ran to completion
+        TimeBudgetExhausted, ///< time budget was exceeded
+        NodeBudgetExhausted, ///< document node budget was exceeded
+        ScriptBudgetExhausted, ///< script invocation budget was exceeded
+        PixelBudgetExhausted, ///< barcode decoding pixel budget was exceeded
+    };
+    /** Returns the budget exhausted during the last extract() call.
+     *  This is reset by clear().
+     */
+    BudgetExhaustion budgetExhaustion() const;
+
     /** Perform the actual extraction, and return the JSON-LD data
      *  that has been found.
      */
     QJsonArray extract();
 
+    /** Cache extraction results persistently in the directory @p path.
+     *  Results for input passed to setData() are then looked up by a hash of the input
+     *  data, the file name extension, the day of the context date, the extraction hints and a
+     *  fingerprint of the loaded extractors and the library version. On a cache hit no document
+     *  parsing or extraction is performed at all, rootDocumentNode() is empty in that case.
+     *  Modification times defaulted from the context date are taken from the current context on a hit.
+     *  This is not used for input passed to setContent() or when a context document
+     *  has been set with setContext(), and results of extraction runs that exhausted
+     *  one of the budgets are not stored.
+     *  The extractor fingerprint is computed when calling this, so changes to the
+     *  extractor repository made afterwards are not considered.
+     *  @param path Cache directory, an empty path disables the cache (the default).
+     *  @param maxSize Maximum size of all cache entries in bytes, least recently used
+     *  entries are evicted beyond that.
+     *  @since 26.12
+     */
+    void setResultCache(const QString &path, qint64 maxSize = 64 * 1024 * 1024);
+
+    /** Collect timing statistics for all processing steps, see statistics().
+     *  This is off by default, and has no noticeable overhead then.
+     *  @since 26.12
+     */
+    void setCollectStatistics(bool collect);
+    /** Timing statistics for one processing step.
+     *  @since 26.12
+     */
+    struct StatisticsEntry {
+        /** Processing step, that is the document processor method (createNode, expandNode,
+         *  preExtract, extract, postExtract), the extractor selection (canHandle), the
+         *  extractor execution (runExtractor) or barcode decoding (decodeBarcode).
+         */
+        QString step;
+        /** MIME type of the document processor, or name of the extractor. */
+        QString name;
+        /** Number of times this step has been executed. */
+        qint64 count = 0;
+        /** Number of times this step found something, for canHandle, runExtractor and decodeBarcode. */
+        qint64 hits = 0;
+        /** Cumulative time spent in this step. */
+        std::chrono::nanoseconds time = {};
+    };
+    /** Statistics collected since enabling collection or the last call to resetStatistics(),
+     *  ordered by the time spent on the corresponding step.
+     *  Note that steps can be nested, such as extractors running as part of the extract step.
+     *  @since 26.12
+     */
+    std::vector<StatisticsEntry> statistics() const;
+    /** Reset collected statistics.
+     *  @since 26.12
+     */
+    void resetStatistics();
+
+    /** Record a timeline of all processing steps, see traceEvents().
+     *  This is off by default, and has no noticeable overhead then.
+     *  @since 26.12
+     */
+    void setRecordTrace(bool record);
+    /** Timeline recorded since enabling it or the last call to resetTrace().
+     *  This contains one complete event for each processing step listed in StatisticsEntry,
+     *  in the Chrome trace event format, so it can be viewed in Perfetto or similar tools
+     *  when wrapped into a @c traceEvents JSON object.
+     *  Timestamps are in microseconds based on @c std::chrono::steady_clock, so this can be
+     *  combined with events recorded by the application or other engine instances.
+     *  @see https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+     *  @since 26.12
+     */
+    QJsonArray traceEvents() const;
+    /** Clear the recorded timeline.
+     *  @since 26.12
+     */
+    void resetTrace();
+
+    /** Memory usage categories, see memoryUsage().
+     *  @since 26.12
+     */
+    enum MemoryCategory {
+        DocumentNodeMemory, ///< document nodes and their content, other than images
+        ImageMemory, ///< decoded images held by document nodes
+        PdfImageCacheMemory, ///< decoded images cached by PDF documents
+        BarcodeCacheMemory, ///< barcode decoding result cache
+    };
+    /** Approximate memory usage of one category, in bytes.
+     *  @since 26.12
+     */
+    struct MemoryUsage {
+        /** Memory currently held. */
+        qint64 current = 0;
+        /** Highest amount of memory held during the last extract() call. */
+        qint64 peak = 0;
+    };
+    /** Track peak memory usage during extract(), see memoryUsage().
+     *  Memory held by document nodes is accounted for as they are created, which
+     *  adds a small cost to every expanded document node and is therefore off by
+     *  default. Setting a soft limit implies this.
+     *  @since 26.12
+     */
+    void setMemoryAccounting(bool enable);
+    /** Approximate memory usage of @p category.
+     *  The current value can be queried at any time, the peak value is only
+     *  available with memory accounting enabled.
+     *  The JavaScript heap of the script engine is not included, as QJSEngine
+     *  provides no way to query it.
+     *  @since 26.12
+     */
+    MemoryUsage memoryUsage(MemoryCategory category) const;
+    /** Soft limit for the memory usage of @p category during extract(), in bytes.
+     *  Exceeding this results in the barcode cache or the PDF image caches being cleared,
+     *  or in decoded images of already processed document nodes being discarded.
+     *  Discarded images are no longer available via rootDocumentNode() afterwards.
+     *  A limit of 0 means unlimited, which is the default.
+     *  DocumentNodeMemory cannot be limited, as document nodes are needed for
+     *  producing the result. Setting a limit for it is rejected with a warning.
+     *  @since 26.12
+     */
+    void setMemorySoftLimit(MemoryCategory category, qint64 bytes);
+
     /** Returns the extractor id used to obtain the result.
      *  Can be empty if generic extractors have been used.
      *  Not supposed to be used for normal operations, this is only needed for tooling.
@@ -206,6 +372,17 @@ public:
      *  For use by the script engine, do not use manually.
      */
     void processNode(ExtractorDocumentNode &node) const;
+
+    /** Cooperative budget checks, for use by document processors and extractors.
+     *  These return @c false once the corresponding budget is exhausted, processing
+     *  should be stopped then.
+     *  @see setTimeBudget
+     */
+    bool checkTimeBudget() const;
+    /** Account for one script invocation. */
+    bool consumeScriptBudget() const;
+    /** Account for @p pixels image pixels about to be analyzed. */
+    bool consumePixelBudget(qint64 pixels) const;
     ///@endcond
 
 private:
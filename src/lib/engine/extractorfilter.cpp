@@ -100,7 +100,9 @@ bool ExtractorFilter::load(const QJsonObject &obj)
     d->m_exp.setPattern(obj.value(QLatin1StringView("match")).toString());
     d->m_scope = readEnum<ExtractorFilter::Scope>(
         obj.value(QLatin1StringView("scope")), ExtractorFilter::Current);
-    return !d->m_mimeType.isEmpty() && (!d->m_fieldName.isEmpty() || !needsFieldName(d->m_mimeType)) && d->m_exp.isValid();
+    // the pattern is only compiled on first use, as most filters are never needed in a given process,
+    // ScriptExtractor checks the patterns of non built-in extractors right away
+    return !d->m_mimeType.isEmpty() && (!d->m_fieldName.isEmpty() || !needsFieldName(d->m_mimeType));
 }
 
 QJsonObject ExtractorFilter::toJson() const
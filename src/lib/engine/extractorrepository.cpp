@@ -7,6 +7,7 @@
 #include "config-kitinerary.h"
 #include "extractorrepository.h"
 
+#include "extractorstatistics_p.h"
 #include "logging.h"
 #include "extractors/activitypubextractor.h"
 #include "extractors/genericboardingpassextractor.h"
@@ -23,8 +24,12 @@
 #include <QMetaProperty>
 #include <QStandardPaths>
 
+using namespace Qt::Literals::StringLiterals;
 using namespace KItinerary;
 
+constexpr inline auto BuiltInExtractorPath = ":/org.kde.pim/kitinerary/extractors"_L1;
+constexpr inline auto BuiltInExtractorIndex = ":/org.kde.pim/kitinerary/extractor-index.json"_L1;
+
 static void initResources() // must be outside of a namespace
 {
     Q_INIT_RESOURCE(extractors);
@@ -39,6 +44,8 @@ public:
     void loadAll();
     void initBuiltInExtractors();
     void loadScriptExtractors();
+    void loadScriptExtractors(const QJsonValue &metaData, const QString &fileName);
+    bool loadScriptExtractorIndex();
     void addExtractor(std::unique_ptr<AbstractExtractor> &&e);
 
     std::vector<std::unique_ptr<AbstractExtractor>> m_extractors;
@@ -90,8 +97,14 @@ void ExtractorRepository::extractorsForNode(const ExtractorDocumentNode &node, s
         return;
     }
 
+    const auto stats = ExtractorStatistics::current();
     for (const auto &extractor : d->m_extractors) {
-        if (extractor->canHandle(node)) {
+        ExtractorStatistics::Timer timer(stats, ExtractorStatistics::CanHandle);
+        const auto canHandle = extractor->canHandle(node);
+        if (stats) { // avoid the name lookup otherwise, this is a hot loop
+            timer.stop(extractor->name(), canHandle);
+        }
+        if (canHandle) {
             // while we only would add each extractor at most once, some of them might already be in the list, so de-duplicate
             const auto it = std::lower_bound(extractors.begin(), extractors.end(), extractor.get(), [](auto lhs, auto rhs) {
                 return lhs < rhs;
@@ -121,9 +134,13 @@ void ExtractorRepositoryPrivate::loadScriptExtractors()
     for (const auto &p : qsp) {
       searchDirs.push_back(p + QLatin1StringView("/kitinerary/extractors"));
     }
-    searchDirs += QStringLiteral(":/org.kde.pim/kitinerary/extractors");
+    searchDirs += QString(BuiltInExtractorPath);
 
     for (const auto &dir : std::as_const(searchDirs)) {
+        if (dir == BuiltInExtractorPath && loadScriptExtractorIndex()) {
+            continue;
+        }
+
         QDirIterator it(dir, QDir::Files);
         while (it.hasNext()) {
             const auto fileName = it.next();
@@ -143,35 +160,58 @@ void ExtractorRepositoryPrivate::loadScriptExtractors()
                 continue;
             }
 
-            QFileInfo fi(fileName);
-            const auto name = fi.fileName().left(fi.fileName().size() - 5);
-
-            if (doc.isObject()) {
-                const auto obj = doc.object();
-                auto ext = std::make_unique<ScriptExtractor>();
-                if (ext->load(obj, fi.canonicalFilePath())) {
-                    addExtractor(std::move(ext));
-                } else {
-                    qCWarning(Log) << "failed to load extractor:" << fi.canonicalFilePath();
-                }
-            } else if (doc.isArray()) {
-                const auto extractorArray = doc.array();
-                int i = 0;
-                for (const auto &v : extractorArray) {
-                    auto ext = std::make_unique<ScriptExtractor>();
-                    if (ext->load(v.toObject(), fi.canonicalFilePath(), extractorArray.size() == 1 ? -1 : i)) {
-                        addExtractor(std::move(ext));
-                    } else {
-                        qCWarning(Log) << "failed to load extractor:" << fi.canonicalFilePath();
-                    }
-                    ++i;
-                }
+            loadScriptExtractors(doc.isObject() ? QJsonValue(doc.object()) : QJsonValue(doc.array()), QFileInfo(fileName).canonicalFilePath());
+        }
+    }
+}
+
+void ExtractorRepositoryPrivate::loadScriptExtractors(const QJsonValue &metaData, const QString &fileName)
+{
+    if (metaData.isObject()) {
+        auto ext = std::make_unique<ScriptExtractor>();
+        if (ext->load(metaData.toObject(), fileName)) {
+            addExtractor(std::move(ext));
+        } else {
+            qCWarning(Log) << "failed to load extractor:" << fileName;
+        }
+    } else if (metaData.isArray()) {
+        const auto extractorArray = metaData.toArray();
+        int i = 0;
+        for (const auto &v : extractorArray) {
+            auto ext = std::make_unique<ScriptExtractor>();
+            if (ext->load(v.toObject(), fileName, extractorArray.size() == 1 ? -1 : i)) {
+                addExtractor(std::move(ext));
             } else {
-                qCWarning(Log) << "Invalid extractor meta-data:" << fileName;
-                continue;
+                qCWarning(Log) << "failed to load extractor:" << fileName;
             }
+            ++i;
         }
+    } else {
+        qCWarning(Log) << "Invalid extractor meta-data:" << fileName;
+    }
+}
+
+// the built-in extractors come with an index of all their meta-data generated at build time,
+// which saves us from opening and parsing each meta-data file individually
+bool ExtractorRepositoryPrivate::loadScriptExtractorIndex()
+{
+    QFile file(BuiltInExtractorIndex);
+    if (!file.open(QFile::ReadOnly)) {
+        return false;
+    }
+
+    QJsonParseError error;
+    const auto doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (!doc.isObject()) {
+        qCWarning(Log) << "Extractor index loading error:" << file.fileName() << error.errorString();
+        return false;
+    }
+
+    const auto index = doc.object();
+    for (auto it = index.begin(); it != index.end(); ++it) {
+        loadScriptExtractors(it.value(), QString(BuiltInExtractorPath) + QLatin1Char('/') + it.key());
     }
+    return true;
 }
 
 void ExtractorRepositoryPrivate::addExtractor(std::unique_ptr<AbstractExtractor> &&e)
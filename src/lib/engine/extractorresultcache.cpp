@@ -0,0 +1,153 @@
+/*
+    SPDX-FileCopyrightText: 2026 KItinerary contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <kitinerary_version.h>
+
+#include "extractorresultcache_p.h"
+#include "extractorrepository.h"
+#include "logging.h"
+#include "scriptextractor.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+using namespace Qt::Literals::StringLiterals;
+using namespace KItinerary;
+
+// cache format version, bump when changing the entry format
+constexpr inline int CacheFormatVersion = 1;
+
+// when evicting, free up a bit more than needed to not have to evict on every insert
+constexpr inline double EvictionTargetRatio = 0.75;
+
+ExtractorResultCache::ExtractorResultCache(const QString &path, qint64 maxSize)
+    : m_path(path)
+    , m_maxSize(maxSize)
+{
+    QDir().mkpath(m_path);
+}
+
+ExtractorResultCache::~ExtractorResultCache() = default;
+
+static void addFileFingerprint(QCryptographicHash &hash, const QString &fileName)
+{
+    hash.addData(fileName.toUtf8());
+    // built-in files are covered by the library version
+    if (fileName.startsWith(':'_L1)) {
+        return;
+    }
+    const QFileInfo fi(fileName);
+    hash.addData(QByteArray::number(fi.size()));
+    hash.addData(QByteArray::number(fi.lastModified().toMSecsSinceEpoch()));
+}
+
+QByteArray ExtractorResultCache::repositoryFingerprint(const ExtractorRepository &repo)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(KITINERARY_VERSION_STRING);
+    hash.addData(QByteArray::number(CacheFormatVersion));
+    for (const auto &path : repo.additionalSearchPaths()) {
+        hash.addData(path.toUtf8());
+    }
+    for (const auto &ext : repo.extractors()) {
+        hash.addData(ext->name().toUtf8());
+        if (const auto scriptExt = dynamic_cast<const ScriptExtractor*>(ext.get())) {
+            addFileFingerprint(hash, scriptExt->fileName());
+            addFileFingerprint(hash, scriptExt->scriptFileName());
+        }
+    }
+    return hash.result();
+}
+
+QString ExtractorResultCache::entryPath(const QByteArray &key) const
+{
+    return m_path + '/'_L1 + QString::fromLatin1(key.toHex()) + ".json"_L1;
+}
+
+bool ExtractorResultCache::lookup(const QByteArray &key, QJsonArray &result, QString &usedExtractor) const
+{
+    QFile f(entryPath(key));
+    if (!f.open(QFile::ReadOnly)) {
+        return false;
+    }
+    const auto doc = QJsonDocument::fromJson(f.readAll());
+    if (!doc.isObject()) {
+        qCWarning(Log) << "Invalid extractor result cache entry" << f.fileName();
+        return false;
+    }
+    const auto obj = doc.object();
+    result = obj.value("result"_L1).toArray();
+    usedExtractor = obj.value("usedExtractor"_L1).toString();
+
+    // mark as recently used for eviction
+    f.close();
+    if (f.open(QFile::ReadWrite)) {
+        f.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    }
+    return true;
+}
+
+void ExtractorResultCache::insert(const QByteArray &key, const QJsonArray &result, const QString &usedExtractor)
+{
+    QJsonObject obj;
+    obj.insert("result"_L1, result);
+    if (!usedExtractor.isEmpty()) {
+        obj.insert("usedExtractor"_L1, usedExtractor);
+    }
+    const auto data = QJsonDocument(obj).toJson(QJsonDocument::Compact);
+
+    QSaveFile f(entryPath(key));
+    if (!f.open(QFile::WriteOnly) || f.write(data) != data.size() || !f.commit()) {
+        qCWarning(Log) << "Failed to write extractor result cache entry:" << f.fileName() << f.errorString();
+        return;
+    }
+
+    if (m_size >= 0) {
+        m_size += data.size();
+    }
+    if (m_maxSize > 0 && size() > m_maxSize) {
+        evict();
+    }
+}
+
+qint64 ExtractorResultCache::size() const
+{
+    if (m_size < 0) {
+        m_size = 0;
+        const auto entries = QDir(m_path).entryInfoList({u"*.json"_s}, QDir::Files);
+        for (const auto &entry : entries) {
+            m_size += entry.size();
+        }
+    }
+    return m_size;
+}
+
+void ExtractorResultCache::evict()
+{
+    // re-scan, other processes might have modified the cache meanwhile
+    auto entries = QDir(m_path).entryInfoList({u"*.json"_s}, QDir::Files, QDir::Time | QDir::Reversed);
+    m_size = 0;
+    for (const auto &entry : entries) {
+        m_size += entry.size();
+    }
+
+    const auto targetSize = (qint64)(m_maxSize * EvictionTargetRatio);
+    for (const auto &entry : entries) {
+        if (m_size <= targetSize) {
+            break;
+        }
+        if (QFile::remove(entry.absoluteFilePath())) {
+            m_size -= entry.size();
+        }
+    }
+}
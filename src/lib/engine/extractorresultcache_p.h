@@ -0,0 +1,59 @@
+/*
+    SPDX-FileCopyrightText: 2026 KItinerary contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KITINERARY_EXTRACTORRESULTCACHE_H
+#define KITINERARY_EXTRACTORRESULTCACHE_H
+
+#include "kitinerary_export.h"
+
+#include <QByteArray>
+#include <QString>
+
+class QJsonArray;
+
+namespace KItinerary {
+
+class ExtractorRepository;
+
+/** Persistent on-disk cache for extraction results.
+ *
+ *  Entries are stored as individual files named after their key, so concurrent
+ *  use from several processes is safe (at worst an entry is computed twice).
+ *  Least recently used entries are evicted once the total size exceeds the limit.
+ *
+ *  @internal exported for unit tests only
+ */
+class KITINERARY_EXPORT ExtractorResultCache
+{
+public:
+    explicit ExtractorResultCache(const QString &path, qint64 maxSize);
+    ~ExtractorResultCache();
+
+    /** Fingerprint of the loaded extractors and the library version,
+     *  to be included in all cache keys.
+     */
+    [[nodiscard]] static QByteArray repositoryFingerprint(const ExtractorRepository &repo);
+
+    /** Look up the cached result for @p key. */
+    [[nodiscard]] bool lookup(const QByteArray &key, QJsonArray &result, QString &usedExtractor) const;
+    /** Store @p result for @p key, evicting old entries if necessary. */
+    void insert(const QByteArray &key, const QJsonArray &result, const QString &usedExtractor);
+
+    /** Total size of all cache entries in bytes. */
+    [[nodiscard]] qint64 size() const;
+
+private:
+    [[nodiscard]] QString entryPath(const QByteArray &key) const;
+    void evict();
+
+    QString m_path;
+    qint64 m_maxSize = 0;
+    mutable qint64 m_size = -1;
+};
+
+}
+
+#endif // KITINERARY_EXTRACTORRESULTCACHE_H
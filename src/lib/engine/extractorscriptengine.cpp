@@ -21,11 +21,149 @@
 #include <QJSEngine>
 #include <QJSValueIterator>
 #include <QScopeGuard>
-#include <QThread>
-#include <QTimer>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
 using namespace KItinerary;
 
+namespace {
+constexpr inline auto ScriptTimeout = 1s;
+constexpr inline auto WatchdogCheckInterval = 100ms;
+
+/** Watchdog for script execution, shared by all script engines in this process.
+ *  The watchdog thread only exists while there are script engines using it,
+ *  and only wakes up periodically while a script is actually running.
+ */
+class ScriptWatchdog
+{
+public:
+    ScriptWatchdog();
+    ~ScriptWatchdog();
+
+    [[nodiscard]] static std::shared_ptr<ScriptWatchdog> instance();
+
+    struct Entry {
+        QJSEngine *engine = nullptr;
+        // steady clock time point after which the engine gets interrupted, 0 if disarmed
+        std::atomic<std::chrono::steady_clock::rep> deadline = 0;
+        // serializes interrupting with arming the next execution, so a late interruption
+        // can't hit a script that just started
+        std::mutex interruptMutex;
+    };
+
+    void addEntry(Entry *entry);
+    void removeEntry(Entry *entry);
+    /** Starts the timeout for the next script execution of @p entry, and clears any previous interruption. */
+    void arm(Entry *entry);
+    void disarm(Entry *entry);
+
+private:
+    void run();
+
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::vector<Entry*> m_entries;
+    std::atomic<int> m_armedCount = 0;
+    bool m_quit = false;
+    std::thread m_thread;
+};
+}
+
+ScriptWatchdog::ScriptWatchdog()
+    : m_thread([this]() { run(); })
+{
+}
+
+ScriptWatchdog::~ScriptWatchdog()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_quit = true;
+    }
+    m_cond.notify_one();
+    m_thread.join();
+}
+
+std::shared_ptr<ScriptWatchdog> ScriptWatchdog::instance()
+{
+    static std::mutex s_mutex;
+    static std::weak_ptr<ScriptWatchdog> s_instance;
+
+    std::lock_guard lock(s_mutex);
+    auto watchdog = s_instance.lock();
+    if (!watchdog) {
+        watchdog = std::make_shared<ScriptWatchdog>();
+        s_instance = watchdog;
+    }
+    return watchdog;
+}
+
+void ScriptWatchdog::addEntry(Entry *entry)
+{
+    std::lock_guard lock(m_mutex);
+    m_entries.push_back(entry);
+}
+
+void ScriptWatchdog::removeEntry(Entry *entry)
+{
+    std::lock_guard lock(m_mutex);
+    m_entries.erase(std::remove(m_entries.begin(), m_entries.end(), entry), m_entries.end());
+}
+
+void ScriptWatchdog::arm(Entry *entry)
+{
+    {
+        std::lock_guard lock(entry->interruptMutex);
+        entry->deadline.store((std::chrono::steady_clock::now() + ScriptTimeout).time_since_epoch().count(), std::memory_order_relaxed);
+        entry->engine->setInterrupted(false);
+    }
+
+    // wake up the watchdog thread if it was idle, the empty critical section ensures
+    // it's either waiting already or will see the changed count before it waits
+    if (m_armedCount.fetch_add(1) == 0) {
+        { std::lock_guard lock(m_mutex); }
+        m_cond.notify_one();
+    }
+}
+
+void ScriptWatchdog::disarm(Entry *entry)
+{
+    entry->deadline.store(0, std::memory_order_relaxed);
+    m_armedCount.fetch_sub(1);
+}
+
+void ScriptWatchdog::run()
+{
+    std::unique_lock lock(m_mutex);
+    while (!m_quit) {
+        if (m_armedCount.load() == 0) {
+            m_cond.wait(lock, [this]() { return m_quit || m_armedCount.load() > 0; });
+            continue;
+        }
+        m_cond.wait_for(lock, WatchdogCheckInterval);
+        const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        for (auto entry : m_entries) {
+            auto deadline = entry->deadline.load(std::memory_order_relaxed);
+            if (deadline == 0 || deadline >= now) {
+                continue;
+            }
+            std::lock_guard interruptLock(entry->interruptMutex);
+            // if this got re-armed in the meantime, this is a different script execution now
+            if (entry->deadline.compare_exchange_strong(deadline, 0)) {
+                entry->engine->setInterrupted(true);
+            }
+        }
+    }
+}
+
 namespace KItinerary {
 class ExtractorScriptEnginePrivate {
 public:
@@ -36,17 +174,16 @@ public:
     JsApi::JsonLd *m_jsonLdApi = nullptr;
     JsApi::ExtractorEngine *m_engineApi = nullptr;
     QJSEngine m_engine;
+    QString m_loadedScript;
 
-    QThread m_watchdogThread;
-    QTimer *m_watchdogTimer = nullptr;
+    std::shared_ptr<ScriptWatchdog> m_watchdog;
+    ScriptWatchdog::Entry m_watchdogEntry;
 };
 }
 
 ExtractorScriptEnginePrivate::~ExtractorScriptEnginePrivate()
 {
-    m_watchdogTimer->deleteLater();
-    m_watchdogThread.quit();
-    m_watchdogThread.wait();
+    m_watchdog->removeEntry(&m_watchdogEntry);
 }
 
 ExtractorScriptEngine::ExtractorScriptEngine() = default;
@@ -68,12 +205,9 @@ void ExtractorScriptEngine::ensureInitialized()
     d->m_engineApi = new JsApi::ExtractorEngine(&d->m_engine);
     d->m_engine.globalObject().setProperty(QStringLiteral("ExtractorEngine"), d->m_engine.newQObject(d->m_engineApi));
 
-    d->m_watchdogThread.start();
-    d->m_watchdogTimer = new QTimer;
-    d->m_watchdogTimer->setInterval(std::chrono::seconds(1));
-    d->m_watchdogTimer->setSingleShot(true);
-    d->m_watchdogTimer->moveToThread(&d->m_watchdogThread);
-    QObject::connect(d->m_watchdogTimer, &QTimer::timeout, &d->m_engine, [this]() { d->m_engine.setInterrupted(true); }, Qt::DirectConnection);
+    d->m_watchdogEntry.engine = &d->m_engine;
+    d->m_watchdog = ScriptWatchdog::instance();
+    d->m_watchdog->addEntry(&d->m_watchdogEntry);
 }
 
 void ExtractorScriptEngine::setExtractorEngine(ExtractorEngine *engine)
@@ -102,12 +236,19 @@ static void printScriptError(const QJSValue &result, const QString &fileNameFall
 
 bool ExtractorScriptEnginePrivate::loadScript(const QString &fileName)
 {
-    // TODO we could skip this is if the right script is already loaded
-    // we cannot do this unconditionally however without breaking KItinerary Workbench's live editing
     if (fileName.isEmpty()) {
         return false;
     }
 
+    // scripts from resources cannot change at runtime, so we can skip reading and compiling those
+    // again if they are already loaded. Scripts from files are always reloaded though, as
+    // KItinerary Workbench relies on that for live editing.
+    const auto isResource = fileName.startsWith(QLatin1Char(':'));
+    if (isResource && fileName == m_loadedScript) {
+        return true;
+    }
+    m_loadedScript.clear();
+
     QFile f(fileName);
     if (!f.open(QFile::ReadOnly)) {
         qCWarning(Log) << "Failed to open extractor script" << f.fileName() << f.errorString();
@@ -120,6 +261,9 @@ bool ExtractorScriptEnginePrivate::loadScript(const QString &fileName)
         return false;
     }
 
+    if (isResource) {
+        m_loadedScript = fileName;
+    }
     return true;
 }
 
@@ -128,11 +272,10 @@ ExtractorResult ExtractorScriptEngine::execute(const ScriptExtractor *extractor,
     const_cast<ExtractorScriptEngine*>(this)->ensureInitialized();
 
     // watchdog setup
-    QMetaObject::invokeMethod(d->m_watchdogTimer, qOverload<>(&QTimer::start));
+    d->m_watchdog->arm(&d->m_watchdogEntry);
     const auto scopeCleanup = qScopeGuard([this]() {
-        QMetaObject::invokeMethod(d->m_watchdogTimer, qOverload<>(&QTimer::stop));
+        d->m_watchdog->disarm(&d->m_watchdogEntry);
     });
-    d->m_engine.setInterrupted(false);
 
     if (!d->loadScript(extractor->scriptFileName())) {
         return {};
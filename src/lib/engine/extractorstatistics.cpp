@@ -0,0 +1,137 @@
+/*
+    SPDX-FileCopyrightText: 2026 KItinerary contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "extractorstatistics_p.h"
+
+#include <QCoreApplication>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <atomic>
+
+using namespace Qt::Literals::StringLiterals;
+using namespace KItinerary;
+
+static thread_local ExtractorStatistics *s_currentStatistics = nullptr;
+
+// small sequential thread ids, for better readability of trace views than native thread handles
+static std::atomic<int> s_nextThreadId = 1;
+static thread_local int s_threadId = s_nextThreadId++;
+
+static constexpr const QLatin1StringView step_names[] = {
+    "createNode"_L1,
+    "expandNode"_L1,
+    "preExtract"_L1,
+    "extract"_L1,
+    "postExtract"_L1,
+    "canHandle"_L1,
+    "runExtractor"_L1,
+    "decodeBarcode"_L1,
+};
+
+void ExtractorStatistics::setCollectStatistics(bool collect)
+{
+    m_collectStatistics = collect;
+    if (!collect) {
+        clear();
+    }
+}
+
+void ExtractorStatistics::setRecordTrace(bool record)
+{
+    m_recordTrace = record;
+    if (!record) {
+        clearTrace();
+    }
+}
+
+bool ExtractorStatistics::isEnabled() const
+{
+    return m_collectStatistics || m_recordTrace;
+}
+
+void ExtractorStatistics::record(Step step, QStringView name, std::chrono::steady_clock::time_point start, std::chrono::nanoseconds time, bool hit)
+{
+    if (m_collectStatistics) {
+        auto &entry = m_entries[{step, name.toString()}];
+        ++entry.count;
+        entry.hits += hit ? 1 : 0;
+        entry.time += time;
+    }
+    if (m_recordTrace) {
+        m_trace.push_back({name.toString(), start, time, s_threadId, step, hit});
+    }
+}
+
+std::vector<ExtractorEngine::StatisticsEntry> ExtractorStatistics::entries() const
+{
+    std::vector<ExtractorEngine::StatisticsEntry> result;
+    result.reserve(m_entries.size());
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        ExtractorEngine::StatisticsEntry e;
+        e.step = step_names[it.key().first];
+        e.name = it.key().second;
+        e.count = it.value().count;
+        e.hits = it.value().hits;
+        e.time = it.value().time;
+        result.push_back(std::move(e));
+    }
+    std::sort(result.begin(), result.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.time > rhs.time;
+    });
+    return result;
+}
+
+void ExtractorStatistics::clear()
+{
+    m_entries.clear();
+}
+
+QJsonArray ExtractorStatistics::traceEvents() const
+{
+    const auto pid = QCoreApplication::applicationPid();
+    QJsonArray events;
+    for (const auto &ev : m_trace) {
+        QString name = step_names[ev.step];
+        if (!ev.name.isEmpty()) {
+            name += u' ';
+            name += ev.name;
+        }
+        QJsonObject event;
+        event.insert("name"_L1, name);
+        event.insert("cat"_L1, step_names[ev.step]);
+        // complete event, nesting is implied by the time ranges on the same thread
+        event.insert("ph"_L1, "X"_L1);
+        event.insert("ts"_L1, std::chrono::duration<double, std::micro>(ev.start.time_since_epoch()).count());
+        event.insert("dur"_L1, std::chrono::duration<double, std::micro>(ev.duration).count());
+        event.insert("pid"_L1, pid);
+        event.insert("tid"_L1, ev.thread);
+        event.insert("args"_L1, QJsonObject({{"name"_L1, ev.name}, {"hit"_L1, ev.hit}}));
+        events.push_back(event);
+    }
+    return events;
+}
+
+void ExtractorStatistics::clearTrace()
+{
+    m_trace.clear();
+}
+
+ExtractorStatistics* ExtractorStatistics::current()
+{
+    return s_currentStatistics;
+}
+
+ExtractorStatistics::Scope::Scope(ExtractorStatistics *statistics)
+    : m_previous(s_currentStatistics)
+{
+    s_currentStatistics = statistics;
+}
+
+ExtractorStatistics::Scope::~Scope()
+{
+    s_currentStatistics = m_previous;
+}
@@ -0,0 +1,118 @@
+/*
+    SPDX-FileCopyrightText: 2026 KItinerary contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef KITINERARY_EXTRACTORSTATISTICS_H
+#define KITINERARY_EXTRACTORSTATISTICS_H
+
+#include "extractorengine.h"
+
+#include <QHash>
+#include <QJsonArray>
+#include <QString>
+
+#include <chrono>
+
+namespace KItinerary {
+
+/** Collects timing statistics and a timeline of trace events during extraction.
+ *
+ *  Like ExtractorDocumentNodeArena this is made available to all code running
+ *  as part of an extraction via a thread-local current instance, which is @c nullptr
+ *  unless statistics collection or tracing has been enabled on the engine. So when disabled,
+ *  the overhead is a single thread-local lookup per measured step.
+ */
+class ExtractorStatistics
+{
+public:
+    enum Step : quint8 {
+        CreateNode,
+        ExpandNode,
+        PreExtract,
+        Extract,
+        PostExtract,
+        CanHandle,
+        RunExtractor,
+        DecodeBarcode,
+    };
+
+    void setCollectStatistics(bool collect);
+    void setRecordTrace(bool record);
+    /** Returns @c true if either statistics collection or tracing is enabled. */
+    [[nodiscard]] bool isEnabled() const;
+
+    void record(Step step, QStringView name, std::chrono::steady_clock::time_point start, std::chrono::nanoseconds time, bool hit);
+    [[nodiscard]] std::vector<ExtractorEngine::StatisticsEntry> entries() const;
+    void clear();
+    /** Recorded timeline in Chrome trace event format. */
+    [[nodiscard]] QJsonArray traceEvents() const;
+    void clearTrace();
+
+    /** Statistics instance of the extraction running on the current thread, if any. */
+    [[nodiscard]] static ExtractorStatistics* current();
+
+    /** Makes @p statistics the current instance for the lifetime of this object. */
+    class Scope
+    {
+    public:
+        explicit Scope(ExtractorStatistics *statistics);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        ExtractorStatistics *m_previous;
+    };
+
+    /** Measures a single step, does nothing if @p statistics is @c nullptr. */
+    class Timer
+    {
+    public:
+        inline explicit Timer(ExtractorStatistics *statistics, Step step)
+            : m_statistics(statistics)
+            , m_step(step)
+        {
+            if (m_statistics) {
+                m_start = std::chrono::steady_clock::now();
+            }
+        }
+        inline void stop(QStringView name, bool hit = false)
+        {
+            if (m_statistics) {
+                m_statistics->record(m_step, name, m_start, std::chrono::steady_clock::now() - m_start, hit);
+            }
+        }
+
+    private:
+        ExtractorStatistics *m_statistics;
+        std::chrono::steady_clock::time_point m_start;
+        Step m_step;
+    };
+
+private:
+    struct Entry {
+        qint64 count = 0;
+        qint64 hits = 0;
+        std::chrono::nanoseconds time = {};
+    };
+    QHash<std::pair<quint8, QString>, Entry> m_entries;
+
+    struct TraceEvent {
+        QString name;
+        std::chrono::steady_clock::time_point start;
+        std::chrono::nanoseconds duration;
+        int thread;
+        Step step;
+        bool hit;
+    };
+    std::vector<TraceEvent> m_trace;
+
+    bool m_collectStatistics = false;
+    bool m_recordTrace = false;
+};
+
+}
+
+#endif // KITINERARY_EXTRACTORSTATISTICS_H
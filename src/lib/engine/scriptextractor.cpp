@@ -17,6 +17,7 @@
 #include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonObject>
+#include <QRegularExpression>
 
 using namespace KItinerary;
 
@@ -55,6 +56,14 @@ bool ScriptExtractor::load(const QJsonObject &obj, const QString &fileName, int
             qCWarning(Log) << "invalid filter expression:" << fileName;
             return false;
         }
+        // built-in filter patterns are checked by unit tests and compiled on first use only,
+        // anything else could be broken and has to be checked here
+        if (!fileName.startsWith(QLatin1Char(':'))) {
+            if (const QRegularExpression exp(f.pattern()); !exp.isValid()) {
+                qCWarning(Log) << "invalid filter expression:" << fileName << exp.errorString();
+                return false;
+            }
+        }
         d->m_filters.push_back(std::move(f));
     }
 
@@ -85,9 +94,10 @@ QJsonObject ScriptExtractor::toJson() const
     QJsonObject obj;
     obj.insert(QStringLiteral("mimeType"), d->m_mimeType);
 
+    // built-in meta-data comes from the extractor index, so only the directory of it actually exists
     QFileInfo metaFi(d->m_fileName);
     QFileInfo scriptFi(d->m_scriptName);
-    if (metaFi.canonicalPath() == scriptFi.canonicalPath()) {
+    if (QFileInfo(metaFi.path()).canonicalFilePath() == scriptFi.canonicalPath()) {
         obj.insert(QStringLiteral("script"), scriptFi.fileName());
     } else {
         obj.insert(QStringLiteral("script"), d->m_scriptName);
@@ -182,10 +192,16 @@ ExtractorResult ScriptExtractor::extract(const ExtractorDocumentNode &node, cons
     }
 
     if (triggerNodes.empty()) {
+        if (!engine->consumeScriptBudget()) {
+            return {};
+        }
         return engine->scriptEngine()->execute(this, node, node);
     } else {
         ExtractorResult result;
         for (const auto &triggerNode : triggerNodes) {
+            if (!engine->consumeScriptBudget()) {
+                break;
+            }
             result.append(engine->scriptEngine()->execute(this, node, triggerNode));
         }
         return result;
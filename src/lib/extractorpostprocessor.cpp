@@ -200,6 +200,7 @@ QList<QVariant> ExtractorPostprocessor::result() const {
     }
 
     std::stable_sort(d->m_data.begin(), d->m_data.end(), SortUtil::isBefore);
+    d->m_fingerprints.clear();
     return d->m_data;
 }
 
@@ -214,15 +215,27 @@ void ExtractorPostprocessor::setValidationEnabled([[maybe_unused]] bool validate
 
 void ExtractorPostprocessorPrivate::mergeOrAppend(const QVariant &elem)
 {
-    const auto it = std::find_if(m_data.begin(), m_data.end(), [elem](const QVariant &other) {
-        return MergeUtil::isSame(elem, other);
-    });
+    // fingerprints are invalidated by anything modifying m_data outside of here
+    if (m_fingerprints.size() != m_data.size()) {
+        m_fingerprints.clear();
+        m_fingerprints.reserve(m_data.size());
+        for (const auto &other : std::as_const(m_data)) {
+            m_fingerprints.push_back(MergeUtil::fingerprint(other));
+        }
+    }
 
-    if (it == m_data.end()) {
-        m_data.push_back(elem);
-    } else {
-        *it = MergeUtil::merge(*it, elem);
+    const auto fp = MergeUtil::fingerprint(elem);
+    for (qsizetype i = 0; i < m_data.size(); ++i) {
+        if (!MergeUtil::mayBeSame(fp, m_fingerprints[i]) || !MergeUtil::isSame(elem, m_data[i])) {
+            continue;
+        }
+        m_data[i] = MergeUtil::merge(m_data[i], elem);
+        m_fingerprints[i] = MergeUtil::fingerprint(m_data[i]);
+        return;
     }
+
+    m_data.push_back(elem);
+    m_fingerprints.push_back(fp);
 }
 
 QVariant ExtractorPostprocessorPrivate::processFlightReservation(FlightReservation res) const
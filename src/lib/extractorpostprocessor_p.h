@@ -7,6 +7,7 @@
 #ifndef KITINERARY_EXTRACTORPOSTPROCESSOR_P_H
 #define KITINERARY_EXTRACTORPOSTPROCESSOR_P_H
 
+#include "mergeutil.h"
 #include "stringutil.h"
 
 #include <QDateTime>
@@ -82,6 +83,8 @@ public:
     template <typename T> QDateTime processTimeForLocation(QDateTime dt, const T &place) const;
 
     QList<QVariant> m_data;
+    /** MergeUtil fingerprints of m_data, for speeding up mergeOrAppend(). */
+    QList<MergeUtil::Fingerprint> m_fingerprints;
     QDateTime m_contextDate;
     bool m_resultFinalized = false;
 };
@@ -13,14 +13,24 @@
 #include <KPkPass/Pass>
 
 #include <KZip>
+#include <KZipFileEntry>
 
 #include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QString>
+#include <QtEndian>
 #include <QUuid>
 
+#include <zlib.h>
+
+#include <algorithm>
+#include <optional>
+
 using namespace Qt::Literals::StringLiterals;
 using namespace KItinerary;
 
@@ -28,12 +38,407 @@ namespace KItinerary {
 class FilePrivate
 {
 public:
+    [[nodiscard]] bool isOpen() const;
+    [[nodiscard]] QStringList entries(const QString &dirPath) const;
+    [[nodiscard]] bool isDirectory(const QString &path) const;
+    [[nodiscard]] bool hasFile(const QString &path) const;
+    [[nodiscard]] QByteArray fileData(const QString &path);
+    [[nodiscard]] QDateTime fileTime(const QString &path) const;
+
+    [[nodiscard]] bool openZip(QIODevice::OpenMode mode);
+    [[nodiscard]] bool openIndex();
+    [[nodiscard]] bool readIndex();
+    void closeIndex();
+    void dropIndex();
+    [[nodiscard]] bool writeIndex(qint64 &offset, qint64 &size);
+    void writeIndexLocation(qint64 offset, qint64 size);
+
     QString fileName;
     QIODevice *device = nullptr;
     std::unique_ptr<KZip> zipFile;
+    File::Format reservationFormat = File::JsonFormat;
+
+    // indexed read access, bypassing KZip entirely
+    struct IndexEntry {
+        qint64 offset = 0; // of the local file header
+        qint64 compressedSize = 0;
+        qint64 size = 0;
+        int method = 0;
+        std::optional<quint32> crc;
+        QDateTime mtime;
+    };
+    QHash<QString, IndexEntry> index;
+    QHash<QString, QStringList> indexDirectories; // directory path -> entries in that directory
+    QIODevice *indexDevice = nullptr;
+    std::unique_ptr<QFile> indexFile;
+    bool closeIndexDevice = false;
 };
 }
 
+// The index is a regular archive member listing the position of all other members,
+// and is located via the archive comment, so readers don't need to parse the entire
+// central directory and local file headers.
+constexpr inline auto IndexFileName = "index.json"_L1;
+constexpr inline const char IndexCommentPrefix[] = "KItinerary-Index:";
+constexpr inline qint64 EndOfCentralDirectorySize = 22;
+constexpr inline qint64 LocalFileHeaderSize = 30;
+constexpr inline int ZipMethodStored = 0;
+constexpr inline int ZipMethodDeflated = 8;
+
+[[nodiscard]] static bool readIndexLocation(QIODevice *dev, qint64 &offset, qint64 &size)
+{
+    const auto fileSize = dev->size();
+    const auto tailSize = std::min<qint64>(fileSize, EndOfCentralDirectorySize + 64);
+    if (tailSize < EndOfCentralDirectorySize || !dev->seek(fileSize - tailSize)) {
+        return false;
+    }
+    const auto tail = dev->read(tailSize);
+    const auto eocdIdx = tail.lastIndexOf("PK\x05\x06");
+    if (eocdIdx < 0 || tail.size() - eocdIdx < EndOfCentralDirectorySize) {
+        return false;
+    }
+    const auto commentSize = qFromLittleEndian<quint16>(tail.constData() + eocdIdx + 20);
+    if (eocdIdx + EndOfCentralDirectorySize + commentSize != tail.size()) {
+        return false;
+    }
+    const auto comment = QByteArrayView(tail).mid(eocdIdx + EndOfCentralDirectorySize);
+    if (!comment.startsWith(IndexCommentPrefix)) {
+        return false;
+    }
+    constexpr qsizetype prefixSize = sizeof(IndexCommentPrefix) - 1;
+    const auto sep = comment.lastIndexOf(':');
+    bool offsetOk = false;
+    bool sizeOk = false;
+    offset = comment.mid(prefixSize, sep - prefixSize).toLongLong(&offsetOk);
+    size = comment.mid(sep + 1).toLongLong(&sizeOk);
+    return offsetOk && sizeOk;
+}
+
+/** Reads the archive member described by @p entry into @p data.
+ *  The local file header has to match @p name and the data has to match the CRC-32
+ *  of @p entry if it has one, anything else means the index doesn't describe this archive.
+ */
+[[nodiscard]] static bool readEntryData(QIODevice *dev, const QString &name, const FilePrivate::IndexEntry &entry, QByteArray &data)
+{
+    if (!dev->seek(entry.offset)) {
+        return false;
+    }
+    const auto header = dev->read(LocalFileHeaderSize);
+    if (header.size() != LocalFileHeaderSize || !header.startsWith("PK\x03\x04")) {
+        qCWarning(Log) << "Invalid local file header in indexed archive" << entry.offset;
+        return false;
+    }
+    const auto nameSize = qFromLittleEndian<quint16>(header.constData() + 26);
+    const auto extraSize = qFromLittleEndian<quint16>(header.constData() + 28);
+    if (dev->read(nameSize) != name.toUtf8()) {
+        qCWarning(Log) << "Local file header doesn't match index entry" << name;
+        return false;
+    }
+    if (!dev->seek(entry.offset + LocalFileHeaderSize + nameSize + extraSize)) {
+        return false;
+    }
+    data = dev->read(entry.compressedSize);
+    if (data.size() != entry.compressedSize) {
+        return false;
+    }
+
+    if (entry.method == ZipMethodDeflated && entry.size > 0) {
+        QByteArray output;
+        output.resize(entry.size);
+        z_stream stream;
+        stream.zalloc = nullptr;
+        stream.zfree = nullptr;
+        stream.opaque = nullptr;
+        stream.avail_in = data.size();
+        stream.next_in = reinterpret_cast<unsigned char*>(data.data());
+        stream.avail_out = output.size();
+        stream.next_out = reinterpret_cast<unsigned char*>(output.data());
+
+        inflateInit2(&stream, -MAX_WBITS); // raw deflate data, without zlib header
+        const auto res = ::inflate(&stream, Z_FINISH);
+        inflateEnd(&stream);
+        if (res != Z_STREAM_END || stream.avail_out != 0) {
+            qCWarning(Log) << "zlib decompression failed" << res;
+            return false;
+        }
+        data = std::move(output);
+    } else if (entry.method == ZipMethodDeflated) {
+        data.clear();
+    } else if (entry.method != ZipMethodStored) {
+        qCWarning(Log) << "Unsupported compression method in indexed archive" << entry.method;
+        return false;
+    }
+
+    if (entry.crc && ::crc32(::crc32(0, nullptr, 0), reinterpret_cast<const unsigned char*>(data.constData()), data.size()) != *entry.crc) {
+        qCWarning(Log) << "CRC-32 mismatch in indexed archive" << name;
+        return false;
+    }
+    return true;
+}
+
+/** Adds @p path to the directory containing it in @p dirs, and that directory to its parent directory. */
+static void addIndexDirectoryEntry(QHash<QString, QStringList> &dirs, const QString &path)
+{
+    const auto idx = path.lastIndexOf('/'_L1);
+    if (idx <= 0) {
+        return;
+    }
+    const auto dirPath = path.left(idx);
+    auto it = dirs.find(dirPath);
+    const auto isNewDir = it == dirs.end();
+    if (isNewDir) {
+        it = dirs.insert(dirPath, {});
+    }
+    (*it).push_back(path.mid(idx + 1));
+    if (isNewDir) {
+        addIndexDirectoryEntry(dirs, dirPath);
+    }
+}
+
+static void addIndexEntries(const KArchiveDirectory *dir, QJsonArray &entries)
+{
+    const auto names = dir->entries();
+    for (const auto &name : names) {
+        const auto entry = dir->entry(name);
+        if (entry->isDirectory()) {
+            addIndexEntries(static_cast<const KArchiveDirectory*>(entry), entries);
+            continue;
+        }
+        const auto file = dynamic_cast<const KZipFileEntry*>(entry);
+        if (!file || file->path() == IndexFileName) {
+            continue;
+        }
+        QJsonObject obj;
+        obj.insert("name"_L1, file->path());
+        obj.insert("offset"_L1, file->headerStart());
+        obj.insert("compressedSize"_L1, file->compressedSize());
+        obj.insert("size"_L1, file->size());
+        obj.insert("method"_L1, file->encoding());
+        obj.insert("crc"_L1, static_cast<qint64>(file->crc32()));
+        obj.insert("mtime"_L1, file->date().toSecsSinceEpoch());
+        entries.push_back(obj);
+    }
+}
+
+bool FilePrivate::isOpen() const
+{
+    return zipFile || indexDevice;
+}
+
+QStringList FilePrivate::entries(const QString &dirPath) const
+{
+    if (indexDevice) {
+        return indexDirectories.value(dirPath);
+    }
+
+    const auto dir = dynamic_cast<const KArchiveDirectory *>(zipFile->directory()->entry(dirPath));
+    return dir ? dir->entries() : QStringList();
+}
+
+bool FilePrivate::isDirectory(const QString &path) const
+{
+    if (indexDevice) {
+        return indexDirectories.contains(path);
+    }
+
+    const auto entry = zipFile->directory()->entry(path);
+    return entry && entry->isDirectory();
+}
+
+bool FilePrivate::hasFile(const QString &path) const
+{
+    if (indexDevice) {
+        return index.contains(path);
+    }
+    return zipFile->directory()->file(path);
+}
+
+QByteArray FilePrivate::fileData(const QString &path)
+{
+    if (indexDevice) {
+        const auto it = index.constFind(path);
+        if (it == index.constEnd()) {
+            return {};
+        }
+        QByteArray data;
+        if (readEntryData(indexDevice, path, *it, data)) {
+            return data;
+        }
+        dropIndex();
+    }
+
+    const auto file = zipFile->directory()->file(path);
+    return file ? file->data() : QByteArray();
+}
+
+QDateTime FilePrivate::fileTime(const QString &path) const
+{
+    if (indexDevice) {
+        const auto it = index.constFind(path);
+        return it == index.constEnd() ? QDateTime() : (*it).mtime;
+    }
+
+    const auto file = zipFile->directory()->file(path);
+    return file ? file->date() : QDateTime();
+}
+
+bool FilePrivate::openZip(QIODevice::OpenMode mode)
+{
+    if (device) {
+        zipFile = std::make_unique<KZip>(device);
+    } else {
+        zipFile = std::make_unique<KZip>(fileName);
+    }
+    if (!zipFile->open(mode)) {
+        qCWarning(Log) << zipFile->errorString() << fileName;
+        return false;
+    }
+    return true;
+}
+
+bool FilePrivate::openIndex()
+{
+    QIODevice *dev = device;
+    if (!dev) {
+        indexFile = std::make_unique<QFile>(fileName);
+        dev = indexFile.get();
+    }
+    closeIndexDevice = !dev->isOpen();
+    if (closeIndexDevice && !dev->open(QIODevice::ReadOnly)) {
+        indexFile.reset();
+        return false;
+    }
+
+    indexDevice = dev;
+    if (dev->isReadable() && !dev->isSequential() && readIndex()) {
+        return true;
+    }
+
+    // no index, use KZip instead
+    if (!closeIndexDevice) {
+        dev->seek(0);
+    }
+    closeIndex();
+    return false;
+}
+
+bool FilePrivate::readIndex()
+{
+    qint64 offset = 0;
+    qint64 size = 0;
+    if (!readIndexLocation(indexDevice, offset, size)) {
+        return false;
+    }
+    IndexEntry indexEntry;
+    indexEntry.offset = offset;
+    indexEntry.compressedSize = size;
+    indexEntry.size = size;
+    QByteArray indexData;
+    if (!readEntryData(indexDevice, IndexFileName, indexEntry, indexData)) {
+        return false;
+    }
+    const auto doc = QJsonDocument::fromJson(indexData).object();
+    if (doc.value("version"_L1).toInt() != 1) {
+        return false;
+    }
+
+    const auto entries = doc.value("entries"_L1).toArray();
+    index.reserve(entries.size());
+    for (const auto &v : entries) {
+        const auto obj = v.toObject();
+        IndexEntry entry;
+        entry.offset = obj.value("offset"_L1).toInteger();
+        entry.compressedSize = obj.value("compressedSize"_L1).toInteger();
+        entry.size = obj.value("size"_L1).toInteger();
+        entry.method = obj.value("method"_L1).toInt();
+        if (const auto crc = obj.value("crc"_L1); crc.isDouble()) {
+            entry.crc = static_cast<quint32>(crc.toInteger());
+        }
+        entry.mtime = QDateTime::fromSecsSinceEpoch(obj.value("mtime"_L1).toInteger());
+        const auto name = obj.value("name"_L1).toString();
+        if (!index.contains(name)) {
+            addIndexDirectoryEntry(indexDirectories, name);
+        }
+        index.insert(name, entry);
+    }
+    return true;
+}
+
+void FilePrivate::closeIndex()
+{
+    if (indexDevice && closeIndexDevice) {
+        indexDevice->close();
+    }
+    indexDevice = nullptr;
+    indexFile.reset();
+    index.clear();
+    indexDirectories.clear();
+}
+
+void FilePrivate::dropIndex()
+{
+    qCWarning(Log) << "Archive index doesn't match archive content, ignoring it" << fileName;
+    if (!closeIndexDevice) {
+        indexDevice->seek(0);
+    }
+    closeIndex();
+    (void)openZip(QIODevice::ReadOnly);
+}
+
+bool FilePrivate::writeIndex(qint64 &offset, qint64 &size)
+{
+    QJsonArray entries;
+    addIndexEntries(zipFile->directory(), entries);
+    QJsonObject doc;
+    doc.insert("version"_L1, 1);
+    doc.insert("entries"_L1, entries);
+
+    // stored uncompressed, so it can be read without knowing its uncompressed size
+    zipFile->setCompression(KZip::NoCompression);
+    if (!zipFile->writeFile(IndexFileName, QJsonDocument(doc).toJson(QJsonDocument::Compact))) {
+        return false;
+    }
+    const auto entry = dynamic_cast<const KZipFileEntry*>(zipFile->directory()->entry(IndexFileName));
+    if (!entry) {
+        return false;
+    }
+    offset = entry->headerStart();
+    size = entry->compressedSize();
+    return true;
+}
+
+void FilePrivate::writeIndexLocation(qint64 offset, qint64 size)
+{
+    std::unique_ptr<QFile> file;
+    QIODevice *dev = device;
+    if (!dev) {
+        file = std::make_unique<QFile>(fileName);
+        dev = file.get();
+    }
+    const auto wasOpen = dev->isOpen();
+    if (!wasOpen && !dev->open(QIODevice::ReadWrite)) {
+        return;
+    }
+
+    const auto fileSize = dev->size();
+    if (dev->isReadable() && dev->isWritable() && !dev->isSequential() && fileSize >= EndOfCentralDirectorySize && dev->seek(fileSize - EndOfCentralDirectorySize)) {
+        // only append to an end of central directory record without an existing comment
+        const auto eocd = dev->read(EndOfCentralDirectorySize);
+        if (eocd.size() == EndOfCentralDirectorySize && eocd.startsWith("PK\x05\x06") && qFromLittleEndian<quint16>(eocd.constData() + 20) == 0) {
+            const auto comment = QByteArray(IndexCommentPrefix) + QByteArray::number(offset) + ':' + QByteArray::number(size);
+            char commentSize[sizeof(quint16)];
+            qToLittleEndian<quint16>(comment.size(), commentSize);
+            dev->seek(fileSize - sizeof(commentSize));
+            dev->write(commentSize, sizeof(commentSize));
+            dev->write(comment);
+        }
+    }
+
+    if (!wasOpen) {
+        dev->close();
+    }
+}
+
 File::File()
     : d(new FilePrivate)
 {
@@ -67,18 +472,19 @@ void File::setFileName(const QString &fileName)
 
 bool File::open(File::OpenMode mode) const
 {
-    if (d->device) {
-        d->zipFile = std::make_unique<KZip>(d->device);
-    } else {
-        d->zipFile = std::make_unique<KZip>(d->fileName);
+    if (mode == File::Read && d->openIndex()) {
+        return true;
     }
 
-    if (!d->zipFile->open(mode == File::Write ? QIODevice::WriteOnly : QIODevice::ReadOnly)) {
-        qCWarning(Log) << d->zipFile->errorString() << d->fileName;
-        return false;
+    auto zipMode = QIODevice::ReadOnly;
+    if (mode == File::Append) {
+        // appending to nothing is just writing
+        const auto existingSize = d->device ? d->device->size() : QFileInfo(d->fileName).size();
+        zipMode = existingSize > 0 ? QIODevice::ReadWrite : QIODevice::WriteOnly;
+    } else if (mode == File::Write) {
+        zipMode = QIODevice::WriteOnly;
     }
-
-    return true;
+    return d->openZip(zipMode);
 }
 
 QString File::errorString() const
@@ -91,27 +497,41 @@ QString File::errorString() const
 
 void File::close()
 {
-    if (d->zipFile) {
-        d->zipFile->close();
+    qint64 indexOffset = -1;
+    qint64 indexSize = 0;
+    if (d->zipFile && d->zipFile->isOpen() && (d->zipFile->mode() & QIODevice::WriteOnly)) {
+        if (!d->writeIndex(indexOffset, indexSize)) {
+            indexOffset = -1;
+        }
+    }
+    if (d->zipFile && !d->zipFile->close()) {
+        indexOffset = -1;
     }
     d->zipFile.reset();
+    if (indexOffset >= 0) {
+        d->writeIndexLocation(indexOffset, indexSize);
+    }
+    d->closeIndex();
 }
 
-QList<QString> File::reservations() const {
-    Q_ASSERT(d->zipFile);
-    const auto resDir = dynamic_cast<const KArchiveDirectory *>(d->zipFile->directory()->entry("reservations"_L1));
-    if (!resDir) {
-        return {};
-    }
+void File::setReservationFormat(File::Format format)
+{
+    d->reservationFormat = format;
+}
 
-    const auto entries = resDir->entries();
+QList<QString> File::reservations() const {
+    Q_ASSERT(d->isOpen());
+    const auto entries = d->entries("reservations"_L1);
     QList<QString> res;
     res.reserve(entries.size());
     for (const auto &entry : entries) {
-      if (!entry.endsWith(".json"_L1)) {
-        continue;
-      }
-        res.push_back(entry.left(entry.size() - 5));
+        if (!entry.endsWith(".json"_L1) && !entry.endsWith(".cbor"_L1)) {
+            continue;
+        }
+        const auto id = entry.left(entry.size() - 5);
+        if (!res.contains(id)) {
+            res.push_back(id);
+        }
     }
 
     return res;
@@ -119,19 +539,24 @@ QList<QString> File::reservations() const {
 
 QVariant File::reservation(const QString &resId) const
 {
-    Q_ASSERT(d->zipFile);
-    const auto resDir = dynamic_cast<const KArchiveDirectory *>(d->zipFile->directory()->entry("reservations"_L1));
-    if (!resDir) {
-        return {};
+    Q_ASSERT(d->isOpen());
+    const QString cborPath = "reservations/"_L1 + resId + ".cbor"_L1;
+    if (d->hasFile(cborPath)) {
+        const auto array = JsonLdDocument::fromCbor(d->fileData(cborPath));
+        if (array.size() != 1) {
+            qCWarning(Log) << "reservation file for" << resId << "contains" << array.size() << "elements!";
+            return {};
+        }
+        return array.at(0);
     }
 
-    const auto file = resDir->file(resId + ".json"_L1);
-    if (!file) {
+    const QString path = "reservations/"_L1 + resId + ".json"_L1;
+    if (!d->hasFile(path)) {
         qCDebug(Log) << "reservation not found" << resId;
         return {};
     }
 
-    const auto doc = QJsonDocument::fromJson(file->data());
+    const auto doc = QJsonDocument::fromJson(d->fileData(path));
     if (doc.isArray()) {
         const auto array = JsonLdDocument::fromJson(doc.array());
         if (array.size() != 1) {
@@ -154,7 +579,14 @@ void File::addReservation(const QVariant &res)
 void File::addReservation(const QString &id, const QVariant &res)
 {
     Q_ASSERT(d->zipFile);
-    d->zipFile->writeFile("reservations/"_L1 + id + ".json"_L1, QJsonDocument(JsonLdDocument::toJson(res)).toJson());
+    switch (d->reservationFormat) {
+        case File::JsonFormat:
+            d->zipFile->writeFile("reservations/"_L1 + id + ".json"_L1, QJsonDocument(JsonLdDocument::toJson(res)).toJson());
+            break;
+        case File::CborFormat:
+            d->zipFile->writeFile("reservations/"_L1 + id + ".cbor"_L1, JsonLdDocument::toCbor({res}));
+            break;
+    }
 }
 
 QString File::passId(const KPkPass::Pass *pass)
@@ -182,22 +614,15 @@ File::PkPassIdentifier File::decodePassId(QStringView passId)
 }
 
 QList<QString> File::passes() const {
-    Q_ASSERT(d->zipFile);
-    const auto passDir = dynamic_cast<const KArchiveDirectory *>(
-        d->zipFile->directory()->entry("passes"_L1));
-    if (!passDir) {
-        return {};
-    }
-
-    const auto entries = passDir->entries();
+    Q_ASSERT(d->isOpen());
+    const auto entries = d->entries("passes"_L1);
     QList<QString> passIds;
     for (const auto &entry : entries) {
-        const auto subdir = dynamic_cast<const KArchiveDirectory*>(passDir->entry(entry));
-        if (!subdir) {
+        if (!d->isDirectory("passes/"_L1 + entry)) {
             continue;
         }
 
-        const auto subEntries = subdir->entries();
+        const auto subEntries = d->entries("passes/"_L1 + entry);
         for (const auto &subEntry : subEntries) {
           if (!subEntry.endsWith(".pkpass"_L1)) {
             continue;
@@ -210,18 +635,13 @@ QList<QString> File::passes() const {
 
 QByteArray File::passData(const QString& passId) const
 {
-    Q_ASSERT(d->zipFile);
-    const auto passDir = dynamic_cast<const KArchiveDirectory *>(d->zipFile->directory()->entry("passes"_L1));
-    if (!passDir) {
-        return {};
-    }
-
-    const auto file = passDir->file(passId + ".pkpass"_L1);
-    if (!file) {
+    Q_ASSERT(d->isOpen());
+    const QString path = "passes/"_L1 + passId + ".pkpass"_L1;
+    if (!d->hasFile(path)) {
         qCDebug(Log) << "pass not found" << passId;
         return {};
     }
-    return file->data();
+    return d->fileData(path);
 }
 
 void File::addPass(KPkPass::Pass* pass, const QByteArray& rawData)
@@ -237,16 +657,11 @@ void File::addPass(const QString &passId, const QByteArray& rawData)
 
 QList<QString> File::documents() const
 {
-    const auto docDir = dynamic_cast<const KArchiveDirectory *>(d->zipFile->directory()->entry("documents"_L1));
-    if (!docDir) {
-        return {};
-    }
-
-    const auto entries = docDir->entries();
+    const auto entries = d->entries("documents"_L1);
     QList<QString> res;
     res.reserve(entries.size());
     for (const auto &entry : entries) {
-        if (docDir->entry(entry)->isDirectory()) {
+        if (d->isDirectory("documents/"_L1 + entry)) {
             res.push_back(entry);
         }
     }
@@ -256,19 +671,14 @@ QList<QString> File::documents() const
 
 QVariant File::documentInfo(const QString &id) const
 {
-    Q_ASSERT(d->zipFile);
-    const auto dir = dynamic_cast<const KArchiveDirectory *>(d->zipFile->directory()->entry("documents/"_L1 + id));
-    if (!dir) {
-        return {};
-    }
-
-    const auto file = dir->file("meta.json"_L1);
-    if (!file) {
+    Q_ASSERT(d->isOpen());
+    const QString path = "documents/"_L1 + id + "/meta.json"_L1;
+    if (!d->hasFile(path)) {
         qCDebug(Log) << "document meta data not found" << id;
         return {};
     }
 
-    const auto doc = QJsonDocument::fromJson(file->data());
+    const auto doc = QJsonDocument::fromJson(d->fileData(path));
     if (doc.isArray()) {
         const auto array = JsonLdDocument::fromJson(doc.array());
         if (array.size() != 1) {
@@ -291,14 +701,12 @@ QByteArray File::documentData(const QString &id) const
     }
     const auto fileName = JsonLd::convert<CreativeWork>(meta).name();
 
-    const auto dir = dynamic_cast<const KArchiveDirectory *>(d->zipFile->directory()->entry("documents/"_L1 + id));
-    Q_ASSERT(dir); // checked by documentInfo already
-    const auto file = dir->file(fileName);
-    if (!file) {
+    const QString path = "documents/"_L1 + id + '/'_L1 + fileName;
+    if (!d->hasFile(path)) {
         qCWarning(Log) << "document data not found" << id << fileName;
         return {};
     }
-    return file->data();
+    return d->fileData(path);
 }
 
 QString File::normalizeDocumentFileName(const QString &name)
@@ -341,13 +749,8 @@ void File::addDocument(const QString &id, const QVariant &docInfo, const QByteAr
 
 QList<QString> File::listCustomData(QStringView scope) const
 {
-    Q_ASSERT(d->zipFile);
-    const auto dir = dynamic_cast<const KArchiveDirectory *>(d->zipFile->directory()->entry("custom/"_L1 + scope));
-    if (!dir) {
-        return {};
-    }
-
-    const auto entries = dir->entries();
+    Q_ASSERT(d->isOpen());
+    const auto entries = d->entries("custom/"_L1 + scope);
     QList<QString> res;
     res.reserve(entries.size());
     std::copy(entries.begin(), entries.end(), std::back_inserter(res));
@@ -356,45 +759,30 @@ QList<QString> File::listCustomData(QStringView scope) const
 
 bool File::hasCustomData(QStringView scope, const QString &id) const
 {
- Q_ASSERT(d->zipFile);
-    const auto dir = dynamic_cast<const KArchiveDirectory *>(d->zipFile->directory()->entry("custom/"_L1 + scope));
-    if (!dir) {
-        return false;
-    }
-
-    return dir->file(id);
+    Q_ASSERT(d->isOpen());
+    return d->hasFile("custom/"_L1 + scope + '/'_L1 + id);
 }
 
 QByteArray File::customData(QStringView scope, const QString &id) const
 {
-    Q_ASSERT(d->zipFile);
-    const auto dir = dynamic_cast<const KArchiveDirectory *>(d->zipFile->directory()->entry("custom/"_L1 + scope));
-    if (!dir) {
-        return {};
-    }
-
-    const auto file = dir->file(id);
-    if (!file) {
+    Q_ASSERT(d->isOpen());
+    const QString path = "custom/"_L1 + scope + '/'_L1 + id;
+    if (!d->hasFile(path)) {
         qCDebug(Log) << "custom data not found" << scope << id;
         return {};
     }
-    return file->data();
+    return d->fileData(path);
 }
 
 QDateTime File::customDataFileTime(QStringView scope, const QString &id) const
 {
-    Q_ASSERT(d->zipFile);
-    const auto dir = dynamic_cast<const KArchiveDirectory *>(d->zipFile->directory()->entry("custom/"_L1 + scope));
-    if (!dir) {
-        return {};
-    }
-
-    const auto file = dir->file(id);
-    if (!file) {
+    Q_ASSERT(d->isOpen());
+    const QString path = "custom/"_L1 + scope + '/'_L1 + id;
+    if (!d->hasFile(path)) {
         qCDebug(Log) << "custom data not found" << scope << id;
         return {};
     }
-    return file->date();
+    return d->fileTime(path);
 }
 
 void File::addCustomData(QStringView scope, const QString &id, const QByteArray &data, const QDateTime &mtime)
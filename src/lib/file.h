@@ -34,6 +34,10 @@ class FilePrivate;
  *  - PkPass files. Their identifier is determined by their pass type identifier and their serial number.
  *  - JSON-LD document objects (see KItinerary::CreativeWork) and their associated file content. Each document has a UUID.
  *  - Application-specific data in custom namespaces.
+ *
+ *  Written files contain an index of all elements (since 26.12), which allows reading
+ *  individual elements without processing the entire archive structure first. Files
+ *  without such an index can still be read.
  */
 class KITINERARY_EXPORT File
 {
@@ -52,7 +56,16 @@ public:
     /** Sets the file name. Needs to be done before calling open(). */
     void setFileName(const QString &fileName);
 
-    enum OpenMode { Read, Write };
+    enum OpenMode {
+        Read,
+        Write,
+        /** Add elements to an existing file, or create a new one if it doesn't exist yet.
+         *  Existing content is kept as-is, adding an element with the same identifier as an
+         *  existing one replaces that. The space used by replaced elements is not reclaimed.
+         *  @since 26.12
+         */
+        Append,
+    };
     /** Open the file for reading or writing. A filename needs to be set before calling this.
      *  All read/write operations require the file to be open as a precondition.
      */
@@ -66,6 +79,22 @@ public:
     [[nodiscard]] QList<QString> reservations() const;
     /** Loads the reservation with the given identifier. */
     [[nodiscard]] QVariant reservation(const QString &resId) const;
+    /** Serialization format of reservations.
+     *  @since 26.12
+     */
+    enum Format {
+        /** JSON-LD, readable by all versions. This is the default. */
+        JsonFormat,
+        /** Compact binary format, see JsonLdDocument::toCbor(). Only readable by version 26.12 or later. */
+        CborFormat,
+    };
+    /** Sets the format used for reservations added afterwards.
+     *  Reading supports both formats independent of this. Don't mix formats for the
+     *  same reservation in Append mode, the CBOR version is preferred when reading.
+     *  @since 26.12
+     */
+    void setReservationFormat(Format format);
+
     /** Add a reservation to this file. A new unique identifier will be generated for the reservation. */
     void addReservation(const QVariant &res);
     /** Add a reservation to this file. The given identifier will be used. */
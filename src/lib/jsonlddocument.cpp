@@ -27,9 +27,12 @@
 #include <KItinerary/TrainTrip>
 #include <KItinerary/Visit>
 
+#include <QCborArray>
+#include <QCborValue>
 #include <QDateTime>
 #include <QJsonArray>
 #include <QJsonObject>
+#include <QMutex>
 #include <QMetaProperty>
 #include <QUrl>
 #include <QTimeZone>
@@ -152,6 +155,8 @@ static bool isEmptyJsonLdObject(const QJsonObject &obj)
 static QTimeZone timeZone(const QByteArray &tzId)
 {
     static QHash<QByteArray, QTimeZone> s_tzCache;
+    static QMutex s_tzCacheMutex;
+    QMutexLocker lock(&s_tzCacheMutex);
     const auto it = s_tzCache.constFind(tzId);
     if (it != s_tzCache.constEnd()) {
         return it.value();
@@ -520,6 +525,334 @@ QJsonObject JsonLdDocument::toJson(const QVariant& data)
     return obj;
 }
 
+// Binary serialization:
+// The document is an array of format version, elements and string table, prefixed by
+// the CBOR self-description tag. Objects are arrays of the string table index of their
+// type name followed by pairs of property name index and value, enum values are string
+// table indexes as well. Unlike the type registry, the string table is stable across
+// versions and independent of the registration of custom types.
+constexpr inline qint64 CborFormatVersion = 1;
+
+namespace {
+class CborEncoder
+{
+public:
+    [[nodiscard]] QCborValue encode(const QVariant &v);
+
+    QCborArray strings;
+
+private:
+    [[nodiscard]] qint64 stringIndex(const QByteArray &s);
+
+    QHash<QByteArray, qint64> m_stringIndex;
+};
+
+class CborDecoder
+{
+public:
+    explicit CborDecoder(const QCborArray &strings);
+    [[nodiscard]] QVariant decodeObject(const QCborArray &obj) const;
+
+private:
+    [[nodiscard]] QVariant decodeValue(const QMetaProperty &prop, const QCborValue &v) const;
+    [[nodiscard]] QByteArray string(const QCborValue &idx) const;
+
+    std::vector<QByteArray> m_strings;
+};
+}
+
+qint64 CborEncoder::stringIndex(const QByteArray &s)
+{
+    const auto it = m_stringIndex.constFind(s);
+    if (it != m_stringIndex.constEnd()) {
+        return it.value();
+    }
+    const auto idx = strings.size();
+    strings.push_back(QString::fromUtf8(s));
+    m_stringIndex.insert(s, idx);
+    return idx;
+}
+
+[[nodiscard]] static QCborValue encodeDateTime(const QDateTime &dt)
+{
+    switch (dt.timeSpec()) {
+        case Qt::LocalTime:
+            // floating time, keep the wall clock time
+            return QCborArray{QDateTime(dt.date(), dt.time(), QTimeZone::UTC).toMSecsSinceEpoch()};
+        case Qt::UTC:
+            return QCborArray{dt.toMSecsSinceEpoch(), 0};
+        case Qt::OffsetFromUTC:
+            return QCborArray{dt.toMSecsSinceEpoch(), dt.offsetFromUtc()};
+        case Qt::TimeZone:
+            if (dt.timeZone() == QTimeZone::utc()) {
+                return QCborArray{dt.toMSecsSinceEpoch(), 0};
+            }
+            return QCborArray{dt.toMSecsSinceEpoch(), QString::fromUtf8(dt.timeZone().id())};
+    }
+    return {};
+}
+
+[[nodiscard]] static QDateTime decodeDateTime(const QCborArray &a)
+{
+    if (a.isEmpty()) {
+        return {};
+    }
+    const auto msecs = a.at(0).toInteger();
+    if (a.size() == 1) {
+        const auto dt = QDateTime::fromMSecsSinceEpoch(msecs, QTimeZone::UTC);
+        return QDateTime(dt.date(), dt.time());
+    }
+    const auto tz = a.at(1);
+    if (tz.isString()) {
+        return QDateTime::fromMSecsSinceEpoch(msecs, timeZone(tz.toString().toUtf8()));
+    }
+    const auto offset = tz.toInteger();
+    return QDateTime::fromMSecsSinceEpoch(msecs, offset == 0 ? QTimeZone(QTimeZone::UTC) : QTimeZone::fromSecondsAheadOfUtc(offset));
+}
+
+// same structure as toJsonValue(), so we serialize exactly the same content
+QCborValue CborEncoder::encode(const QVariant &v)
+{
+    const auto mo = QMetaType(v.userType()).metaObject();
+    if (!mo) {
+        // basic types
+        switch (v.userType()) {
+        case QMetaType::QString:
+            return v.toString();
+        case QMetaType::Double:
+            return v.toDouble();
+        case QMetaType::Int:
+            return v.toInt();
+        case QMetaType::QDate:
+            return v.toDate().toJulianDay();
+        case QMetaType::QDateTime:
+            return encodeDateTime(v.toDateTime());
+        case QMetaType::QTime:
+            return v.toTime().msecsSinceStartOfDay();
+        case QMetaType::QUrl:
+            return v.toUrl().toString();
+        case QMetaType::Bool:
+            return v.toBool();
+        case QMetaType::Float:
+            return v.toFloat();
+        default:
+            break;
+        }
+
+        if (v.canConvert<QVariantList>()) {
+            auto iterable = v.value<QSequentialIterable>();
+            if (iterable.size() == 0) {
+                return {};
+            }
+            QCborArray array;
+            for (const auto &var : iterable) {
+                auto value = encode(var);
+                if (!value.isUndefined()) {
+                    array.push_back(std::move(value));
+                }
+            }
+            return array;
+        }
+
+        qCDebug(Log) << "unhandled value:" << v;
+        return {};
+    }
+
+    // composite types
+    QCborArray obj;
+    obj.push_back(stringIndex(typeName(mo, v).toUtf8()));
+    for (int i = 0; i < mo->propertyCount(); ++i) {
+        const auto prop = mo->property(i);
+        if (!prop.isStored()) {
+            continue;
+        }
+
+        if (prop.isEnumType()) { // enums defined in this QMO
+            const auto key = prop.readOnGadget(v.constData()).toInt();
+            obj.push_back(stringIndex(QByteArray::fromRawData(prop.name(), qstrlen(prop.name()))));
+            obj.push_back(stringIndex(QByteArray(prop.enumerator().valueToKey(key))));
+            continue;
+        } else if (QMetaType(prop.userType()).flags() & QMetaType::IsEnumeration) { // external enums
+            obj.push_back(stringIndex(QByteArray::fromRawData(prop.name(), qstrlen(prop.name()))));
+            obj.push_back(prop.readOnGadget(v.constData()).toString());
+            continue;
+        }
+
+        const auto value = prop.readOnGadget(v.constData());
+        if (!JsonLd::valueIsNull(value)) {
+            auto cborVal = encode(value);
+            if (!cborVal.isUndefined()) {
+                obj.push_back(stringIndex(QByteArray::fromRawData(prop.name(), qstrlen(prop.name()))));
+                obj.push_back(std::move(cborVal));
+            }
+        }
+    }
+    if (obj.size() > 1) {
+        return obj;
+    }
+
+    return {};
+}
+
+CborDecoder::CborDecoder(const QCborArray &strings)
+{
+    m_strings.reserve(strings.size());
+    for (const auto &s : strings) {
+        m_strings.push_back(s.toString().toUtf8());
+    }
+}
+
+QByteArray CborDecoder::string(const QCborValue &idx) const
+{
+    const auto i = idx.toInteger(-1);
+    if (i < 0 || i >= (qint64)m_strings.size()) {
+        qCWarning(Log) << "Invalid string table index:" << i;
+        return {};
+    }
+    return m_strings[i];
+}
+
+QVariant CborDecoder::decodeObject(const QCborArray &obj) const
+{
+    const auto type = string(obj.at(0));
+    const auto &registry = typeResgistry();
+    const auto it = std::lower_bound(registry.begin(), registry.end(), type, [](const auto &lhs, const auto &rhs) {
+        return std::strcmp(lhs.name, rhs.constData()) < 0;
+    });
+    if (it == registry.end() || std::strcmp((*it).name, type.constData()) != 0) {
+        qCDebug(Log) << "Unknown type" << type;
+        return {};
+    }
+
+    QVariant value(QMetaType((*it).metaTypeId), nullptr);
+    for (qsizetype i = 1; i + 1 < obj.size(); i += 2) {
+        const auto name = string(obj.at(i));
+        const auto idx = (*it).mo->indexOfProperty(name.constData());
+        if (idx < 0) {
+            qCDebug(Log) << "property" << name << "could not be set on object of type" << (*it).mo->className();
+            continue;
+        }
+        const auto prop = (*it).mo->property(idx);
+        const auto propValue = decodeValue(prop, obj.at(i + 1));
+        if (!propValue.isNull()) {
+            prop.writeOnGadget(value.data(), propValue);
+        }
+    }
+    return value;
+}
+
+QVariant CborDecoder::decodeValue(const QMetaProperty &prop, const QCborValue &v) const
+{
+    // enum handling must be done first, as prop.type() == Int
+    if (prop.isEnumType()) {
+        const auto key = v.isString() ? v.toString().toUtf8() : string(v);
+        bool success = false;
+        const auto value = prop.enumerator().keyToValue(key.constData(), &success);
+        if (success) {
+            return value;
+        }
+        qCWarning(Log) << "Unknown enum value" << key << "for" << prop.typeName();
+        return {};
+    }
+    if (QMetaType(prop.userType()).flags() & QMetaType::IsEnumeration) {
+        QVariant value(v.toString());
+        return value.convert(prop.metaType()) ? value : QVariant();
+    }
+
+    switch (prop.userType()) {
+    case QMetaType::QString:
+        return v.toString();
+    case QMetaType::QDate:
+        return v.isInteger() ? QDate::fromJulianDay(v.toInteger()) : QDate();
+    case QMetaType::QDateTime:
+        return decodeDateTime(v.toArray());
+    case QMetaType::Double:
+    case QMetaType::Float:
+        return v.isDouble() || v.isInteger() ? QVariant(v.toDouble()) : QVariant();
+    case QMetaType::Int:
+        return v.isInteger() ? QVariant((int)v.toInteger()) : QVariant();
+    case QMetaType::Bool:
+        return v.isBool() ? QVariant(v.toBool()) : QVariant();
+    case QMetaType::QTime:
+        return v.isInteger() ? QTime::fromMSecsSinceStartOfDay((int)v.toInteger()) : QTime();
+    case QMetaType::QUrl:
+        return QUrl(v.toString());
+    case QMetaType::QVariantList:
+    {
+        QVariantList l;
+        const auto array = v.toArray();
+        l.reserve(array.size());
+        for (const auto &elem : array) {
+            if (elem.isArray()) {
+                const auto var = decodeObject(elem.toArray());
+                if (!var.isNull()) {
+                    l.push_back(var);
+                }
+            } else if (elem.isString()) {
+                l.push_back(elem.toString());
+            }
+        }
+        return QVariant::fromValue(l);
+    }
+    default:
+        break;
+    }
+
+    if (!v.isArray()) {
+        return {};
+    }
+    return decodeObject(v.toArray());
+}
+
+QByteArray JsonLdDocument::toCbor(const QList<QVariant> &data)
+{
+    CborEncoder encoder;
+    QCborArray elements;
+    for (const auto &d : data) {
+        if (!QMetaType(d.userType()).metaObject()) {
+            continue;
+        }
+        auto value = encoder.encode(d);
+        if (value.isArray()) {
+            elements.push_back(std::move(value));
+        }
+    }
+
+    const QCborValue doc(QCborKnownTags::Signature, QCborArray{CborFormatVersion, elements, encoder.strings});
+    return doc.toCbor();
+}
+
+QList<QVariant> JsonLdDocument::fromCbor(const QByteArray &data)
+{
+    QCborParserError error;
+    auto doc = QCborValue::fromCbor(data, &error);
+    if (error.error != QCborError::NoError) {
+        qCWarning(Log) << "Failed to parse CBOR data:" << error.errorString();
+        return {};
+    }
+    if (doc.isTag() && doc.tag() == QCborTag(QCborKnownTags::Signature)) {
+        doc = doc.taggedValue();
+    }
+
+    const auto docArray = doc.toArray();
+    if (docArray.size() != 3 || docArray.at(0).toInteger() != CborFormatVersion) {
+        qCWarning(Log) << "Unsupported CBOR data format version:" << docArray.at(0).toInteger();
+        return {};
+    }
+
+    const CborDecoder decoder(docArray.at(2).toArray());
+    const auto elements = docArray.at(1).toArray();
+    QList<QVariant> result;
+    result.reserve(elements.size());
+    for (const auto &elem : elements) {
+        auto value = decoder.decodeObject(elem.toArray());
+        if (!value.isNull()) {
+            result.push_back(std::move(value));
+        }
+    }
+    return result;
+}
+
 QVariant JsonLdDocument::readProperty(const QVariant &obj, const char *name)
 {
     const auto mo = QMetaType(obj.userType()).metaObject();
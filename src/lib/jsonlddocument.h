@@ -54,6 +54,21 @@ public:
   /** Serialize instantiated data type to JSON-LD. */
   static KITINERARY_EXPORT QJsonObject toJson(const QVariant &data);
 
+  /** Serialize instantiated data types to a compact binary representation.
+   *  This is based on CBOR (RFC 8949) and covers the same data as toJson(), but type,
+   *  property and enum names are stored only once per document and referenced by index
+   *  elsewhere, and dates and times are stored numerically. This is meant for our own
+   *  storage and transfer, for anything else use JSON-LD.
+   *  @see fromCbor
+   *  @since 26.12
+   */
+  static KITINERARY_EXPORT QByteArray toCbor(const QList<QVariant> &data);
+  /** Deserialize data written by toCbor().
+   *  Unlike fromJson() this does not apply any normalization of externally provided data.
+   *  @since 26.12
+   */
+  static KITINERARY_EXPORT QList<QVariant> fromCbor(const QByteArray &data);
+
   /** JSON-LD serrialization of an invidividual data value.
    *  Unlike the above this also works with primitive types.
    */
@@ -212,6 +212,19 @@ static QString stripDiacritics(const QString &s)
     return res;
 }
 
+namespace {
+/** The Unicode normalization variants we compare location names with. */
+struct NameForms {
+    QString normalized;
+    QString transliterated;
+};
+}
+
+[[nodiscard]] static NameForms nameForms(const QString &s)
+{
+    return {stripDiacritics(s), StringUtil::transliterate(s)};
+}
+
 template <typename It>
 static void advanceToNextRelevantChar(It &it, const It &end)
 {
@@ -337,10 +350,13 @@ static bool isSameLocationName(const QString &lhs, const QString &rhs, LocationU
     }
 
     // check if any of the Unicode normalization approaches helps
-    const auto lhsNormalized = stripDiacritics(lhs);
-    const auto rhsNormalized = stripDiacritics(rhs);
-    const auto lhsTransliterated = StringUtil::transliterate(lhs);
-    const auto rhsTransliterated = StringUtil::transliterate(rhs);
+    // the same few names get compared over and over again, so memoize this
+    const auto lhsForms = StringUtil::memoized<nameForms>(lhs);
+    const auto rhsForms = StringUtil::memoized<nameForms>(rhs);
+    const auto &lhsNormalized = lhsForms.normalized;
+    const auto &rhsNormalized = rhsForms.normalized;
+    const auto &lhsTransliterated = lhsForms.transliterated;
+    const auto &rhsTransliterated = rhsForms.transliterated;
     if (compareSpaceCaseInsenstive(lhsNormalized, rhsNormalized) || compareSpaceCaseInsenstive(lhsNormalized, rhsTransliterated)
         || compareSpaceCaseInsenstive(lhsTransliterated, rhsNormalized) || compareSpaceCaseInsenstive(lhsTransliterated, rhsTransliterated)) {
         return true;
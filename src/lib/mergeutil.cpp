@@ -34,6 +34,7 @@
 #include <QRegularExpression>
 #include <QTimeZone>
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <set>
@@ -421,6 +422,83 @@ bool MergeUtil::isSame(const QVariant& lhs, const QVariant& rhs)
     return true;
 }
 
+[[nodiscard]] static size_t fingerprintHash(const QString &s)
+{
+    return s.isEmpty() ? 0 : qHash(s);
+}
+
+[[nodiscard]] static qint64 fingerprintDay(QDate date)
+{
+    return date.isValid() ? date.toJulianDay() : 0;
+}
+
+// types isSame() only considers equal to elements of the very same type, as nothing derives from them
+[[nodiscard]] static int fingerprintType(const QVariant &elem)
+{
+    static const int types[] = {
+        qMetaTypeId<FlightReservation>(), qMetaTypeId<TrainReservation>(), qMetaTypeId<BusReservation>(),
+        qMetaTypeId<BoatReservation>(), qMetaTypeId<LodgingReservation>(), qMetaTypeId<RentalCarReservation>(),
+        qMetaTypeId<TaxiReservation>(), qMetaTypeId<FoodEstablishmentReservation>(), qMetaTypeId<EventReservation>(),
+        qMetaTypeId<Flight>(), qMetaTypeId<TrainTrip>(), qMetaTypeId<BusTrip>(), qMetaTypeId<BoatTrip>(),
+        qMetaTypeId<RentalCar>(), qMetaTypeId<Taxi>(), qMetaTypeId<Event>(), qMetaTypeId<TouristAttractionVisit>(),
+    };
+    return std::find(std::begin(types), std::end(types), elem.userType()) != std::end(types) ? elem.userType() : 0;
+}
+
+static void fillFlightFingerprint(const Flight &flight, MergeUtil::Fingerprint &fp)
+{
+    fp.day = fingerprintDay(flight.departureDay());
+    fp.key = fingerprintHash(flight.departureAirport().iataCode());
+}
+
+MergeUtil::Fingerprint MergeUtil::fingerprint(const QVariant &elem)
+{
+    Fingerprint fp;
+    fp.type = fingerprintType(elem);
+    if (fp.type == 0) {
+        // anything else only has an unconditional reservation number check
+        if (JsonLd::canConvert<Reservation>(elem)) {
+            fp.reservationNumber = fingerprintHash(JsonLd::convert<Reservation>(elem).reservationNumber());
+        }
+        return fp;
+    }
+
+    if (JsonLd::isA<Flight>(elem)) {
+        fillFlightFingerprint(elem.value<Flight>(), fp);
+        return fp;
+    }
+    if (JsonLd::isA<TrainTrip>(elem)) {
+        fp.day = fingerprintDay(elem.value<TrainTrip>().departureDay());
+        return fp;
+    }
+    if (!JsonLd::canConvert<Reservation>(elem)) {
+        return fp;
+    }
+
+    const auto res = JsonLd::convert<Reservation>(elem);
+    fp.reservationNumber = fingerprintHash(res.reservationNumber());
+    // minimal cancellations match without looking at the content
+    if (res.reservationFor().isNull() || res.reservationStatus() == Reservation::ReservationCancelled) {
+        return fp;
+    }
+
+    if (JsonLd::isA<FlightReservation>(elem)) {
+        // a matching IATA BCBP ticket token overrides everything else
+        if (res.reservedTicket().value<Ticket>().ticketToken().isEmpty()) {
+            fillFlightFingerprint(res.reservationFor().value<Flight>(), fp);
+        }
+    } else if (JsonLd::isA<TrainReservation>(elem)) {
+        fp.day = fingerprintDay(res.reservationFor().value<TrainTrip>().departureDay());
+    } else if (JsonLd::isA<LodgingReservation>(elem)) {
+        fp.day = fingerprintDay(elem.value<LodgingReservation>().checkinTime().date());
+    } else if (JsonLd::isA<RentalCarReservation>(elem)) {
+        fp.day = fingerprintDay(elem.value<RentalCarReservation>().pickupTime().date());
+    } else if (JsonLd::isA<TaxiReservation>(elem)) {
+        fp.day = fingerprintDay(elem.value<TaxiReservation>().pickupTime().date());
+    }
+    return fp;
+}
+
 static bool isSameFlight(const Flight& lhs, const Flight& rhs)
 {
     // if there is a conflict on where this is going, or when, this is obviously not the same flight
@@ -673,8 +751,8 @@ static bool isSameTouristAttraction(const TouristAttraction &lhs, const TouristA
 // compute the "difference" between @p lhs and @p rhs
 static QString diffString(const QString &rawLhs, const QString &rawRhs)
 {
-    const auto lhs = StringUtil::normalize(rawLhs);
-    const auto rhs = StringUtil::normalize(rawRhs);
+    const auto lhs = StringUtil::normalizeMemoized(rawLhs);
+    const auto rhs = StringUtil::normalizeMemoized(rawRhs);
 
     QString diff;
     // this is just a basic linear-time heuristic, this would need to be more something like
@@ -737,13 +815,13 @@ bool MergeUtil::isSamePerson(const Person& lhs, const Person& rhs)
         return true;
     }
 
-    const auto lhsNameT = StringUtil::transliterate(lhs.name());
-    const auto lhsGivenNameT = StringUtil::transliterate(lhs.givenName());
-    const auto lhsFamilyNameT = StringUtil::transliterate(lhs.familyName());
+    const auto lhsNameT = StringUtil::transliterateMemoized(lhs.name());
+    const auto lhsGivenNameT = StringUtil::transliterateMemoized(lhs.givenName());
+    const auto lhsFamilyNameT = StringUtil::transliterateMemoized(lhs.familyName());
 
-    const auto rhsNameT = StringUtil::transliterate(rhs.name());
-    const auto rhsGivenNameT = StringUtil::transliterate(rhs.givenName());
-    const auto rhsFamilyNameT = StringUtil::transliterate(rhs.familyName());
+    const auto rhsNameT = StringUtil::transliterateMemoized(rhs.name());
+    const auto rhsGivenNameT = StringUtil::transliterateMemoized(rhs.givenName());
+    const auto rhsFamilyNameT = StringUtil::transliterateMemoized(rhs.familyName());
 
     if (isNameEqualish(lhsNameT, rhsNameT) || (isNameEqualish(lhsGivenNameT, rhsGivenNameT) && isNameEqualish(lhsFamilyNameT, rhsFamilyNameT))) {
             return true;
@@ -35,6 +35,43 @@ public:
      */
     KITINERARY_EXPORT static bool isSame(const QVariant &lhs, const QVariant &rhs);
 
+    /**
+     * Cheap summary of the identifying properties of an element.
+     *
+     * This contains the exact type, a coarse date and hashes of key identifiers
+     * such as the reservation number, where isSame() would consider a difference in those
+     * to be a mismatch. Unset values are @c 0.
+     *
+     * Computing this is about as expensive as a single isSame() call, so this only
+     * pays off when fingerprints are reused for comparing against many other elements.
+     * @see mayBeSame
+     * @since 26.12
+     */
+    struct Fingerprint {
+        int type = 0;
+        qint64 day = 0;
+        size_t reservationNumber = 0;
+        size_t key = 0;
+    };
+
+    /** Computes the fingerprint for @p elem.
+     *  @since 26.12
+     */
+    KITINERARY_EXPORT static Fingerprint fingerprint(const QVariant &elem);
+
+    /**
+     * Checks whether elements with the fingerprints @p lhs and @p rhs can possibly be the same.
+     * If this returns @c false, isSame() is guaranteed to return @c false as well,
+     * otherwise the full comparison with isSame() is necessary.
+     * @since 26.12
+     */
+    static constexpr inline bool mayBeSame(const Fingerprint &lhs, const Fingerprint &rhs)
+    {
+        const auto conflict = [](auto l, auto r) { return l && r && l != r; };
+        return !conflict(lhs.type, rhs.type) && !conflict(lhs.day, rhs.day)
+            && !conflict(lhs.reservationNumber, rhs.reservationNumber) && !conflict(lhs.key, rhs.key);
+    }
+
     /**
      * Checks if two Person objects refer to the same person.
      *
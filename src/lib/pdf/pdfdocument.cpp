@@ -25,6 +25,7 @@
 #include <UTF.h>
 
 #include <cmath>
+#include <numeric>
 
 using namespace Qt::Literals;
 using namespace KItinerary;
@@ -264,6 +265,23 @@ int PdfPage::height() const
     return pdfToMM(page->getCropHeight());
 }
 
+PdfDocumentPrivate* PdfDocumentPrivate::get(const PdfDocument *doc)
+{
+    return doc->d.get();
+}
+
+qint64 PdfDocumentPrivate::imageCacheSize() const
+{
+    return std::accumulate(m_imageData.begin(), m_imageData.end(), qint64(0), [](qint64 size, const auto &it) {
+        return size + it.second.sizeInBytes();
+    });
+}
+
+void PdfDocumentPrivate::clearImageCache()
+{
+    m_imageData.clear();
+}
+
 
 PdfDocument::PdfDocument(QObject *parent)
     : QObject(parent)
@@ -142,6 +142,7 @@ public:
 private:
     QVariantList pagesVariant() const;
 
+    friend class PdfDocumentPrivate;
     std::unique_ptr<PdfDocumentPrivate> d;
 };
 
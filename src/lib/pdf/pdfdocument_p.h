@@ -22,6 +22,7 @@ class PDFDoc;
 
 namespace KItinerary {
 
+class PdfDocument;
 class PdfDocumentPrivate;
 class PdfLink;
 class PdfPage;
@@ -40,6 +41,13 @@ public:
 
 class PdfDocumentPrivate {
 public:
+    [[nodiscard]] static PdfDocumentPrivate* get(const PdfDocument *doc);
+
+    /** Approximate amount of memory used by m_imageData, in bytes. */
+    [[nodiscard]] qint64 imageCacheSize() const;
+    /** Drop all cached images, they are reloaded on demand. */
+    void clearImageCache();
+
     // needs to be kept alive as long as the Poppler::PdfDoc instance lives
     QByteArray m_pdfData;
     // this contains the actually loaded/decoded image data
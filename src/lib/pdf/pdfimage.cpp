@@ -13,6 +13,9 @@
 #include <QDebug>
 #include <QScopedValueRollback>
 
+#include <algorithm>
+#include <vector>
+
 #include <Gfx.h>
 #include <GlobalParams.h>
 #include <PDFDoc.h>
@@ -21,15 +24,22 @@
 
 using namespace KItinerary;
 
-static inline bool isColor(GfxRGB rgb)
-{
-    enum { Threshold = 72 * 256 }; // GfxComp is stored as color value * 255
+// barcode images for SNCF and Renfe for example are anti-aliased, so we cannot simply filter for black or white
+// KLM/AF use tinted barcodes, so checking for R = G = B doesn't help either
+enum { ColorThreshold = 72 };
 
-    // barcode images for SNCF and Renfe for example are anti-aliased, so we cannot simply filter for black or white
-    // KLM/AF use tinted barcodes, so checking for R = G = B doesn't help either
-    return std::abs(rgb.r - rgb.g) > Threshold || std::abs(rgb.r - rgb.b) > Threshold || std::abs(rgb.g - rgb.b) > Threshold;
+static inline bool isColor(QRgb rgb)
+{
+    const auto r = qRed(rgb);
+    const auto g = qGreen(rgb);
+    const auto b = qBlue(rgb);
+    return std::abs(r - g) > ColorThreshold || std::abs(r - b) > ColorThreshold || std::abs(g - b) > ColorThreshold;
 }
 
+// only check every n-th row for color content, colored images typically have that
+// in large areas, so this is enough to abort early without checking every single pixel
+enum { ColorCheckRowStride = 4 };
+
 QImage PdfImagePrivate::load(Stream* str, GfxImageColorMap* colorMap)
 {
     if (m_format == QImage::Format_Mono) { // bitmasks are not stored as image streams
@@ -42,9 +52,10 @@ QImage PdfImagePrivate::load(Stream* str, GfxImageColorMap* colorMap)
         const int rowSize = (m_sourceWidth + 7) / 8;
         for (int y = 0; y < m_sourceHeight; ++y) {
             auto imgData = img.scanLine(y);
+            const auto n = std::max(0, str->doGetChars(rowSize, imgData));
+            std::fill(imgData + n, imgData + rowSize, 0xff); // premature end of data, as for EOF below
             for (int x = 0; x < rowSize; x++) {
-                const auto c = str->getChar();
-                *imgData++ = c ^ 0xff;
+                imgData[x] ^= 0xff;
             }
         }
 
@@ -65,35 +76,51 @@ QImage PdfImagePrivate::load(Stream* str, GfxImageColorMap* colorMap)
     imgStream->rewind();
 #endif
 
+    // the line-based color map conversion methods make use of the lookup tables
+    // Poppler has for the common color spaces and indexed palettes, which is much
+    // faster than converting each pixel on its own
     switch (m_format) {
         case QImage::Format_RGB888:
+        {
+            std::vector<unsigned int> rgbLine(m_sourceWidth);
             for (int i = 0; i < m_sourceHeight; ++i) {
                 const auto row = imgStream->getLine();
+                if (!row) {
+                    return {};
+                }
+                colorMap->getRGBLine(row, rgbLine.data(), m_sourceWidth);
+                if ((m_loadingHints & PdfImage::AbortOnColorHint) && (i % ColorCheckRowStride == 0 || i == m_sourceHeight - 1)
+                    && std::any_of(rgbLine.begin(), rgbLine.end(), isColor)) {
+                    return {};
+                }
+
                 auto imgData = img.scanLine(i);
-                GfxRGB rgb;
-                for (int j = 0; j < m_sourceWidth; ++j) {
-                    colorMap->getRGB(row + (j * bytesPerPixel), &rgb);
-                    if ((m_loadingHints & PdfImage::AbortOnColorHint) && isColor(rgb)) {
-                        return {};
+                if ((m_loadingHints & PdfImage::ConvertToGrayscaleHint)) {
+                    for (const auto rgb : rgbLine) {
+                        *imgData++ = qGreen(rgb); // technically not correct but good enough
                     }
-                    if ((m_loadingHints & PdfImage::ConvertToGrayscaleHint)) {
-                        *imgData++ = colToByte(rgb.g); // technically not correct but good enough
-                    } else {
-                        *imgData++ = colToByte(rgb.r);
-                        *imgData++ = colToByte(rgb.g);
-                        *imgData++ = colToByte(rgb.b);
+                } else {
+                    for (const auto rgb : rgbLine) {
+                        *imgData++ = qRed(rgb);
+                        *imgData++ = qGreen(rgb);
+                        *imgData++ = qBlue(rgb);
                     }
                 }
             }
             break;
+        }
         case QImage::Format_Grayscale8:
             for (int i = 0; i < m_sourceHeight; ++i) {
                 const auto row = imgStream->getLine();
+                if (!row) {
+                    return {};
+                }
                 auto imgData = img.scanLine(i);
-                GfxGray gray;
-                for (int j = 0; j < m_sourceWidth; ++j) {
-                    colorMap->getGray(row + j, &gray);
-                    *imgData++ = m_ref.m_type == PdfImageType::SMask ? (colToByte(gray) ^ 0xff) : colToByte(gray);
+                colorMap->getGrayLine(row, imgData, m_sourceWidth);
+                if (m_ref.m_type == PdfImageType::SMask) {
+                    for (int j = 0; j < m_sourceWidth; ++j) {
+                        imgData[j] ^= 0xff;
+                    }
                 }
             }
             break;
@@ -194,7 +221,7 @@ QImage PdfImage::image() const
         return d->m_inlineImageData;
     }
     if (d->m_format == QImage::Format_Invalid) {
-        return d->m_vectorPicture.renderToImage();
+        return d->m_vectorPicture.renderToImage((d->m_loadingHints & PdfImage::RenderVectorPathsHint) ? PdfVectorPicture::PaintPaths : PdfVectorPicture::ModuleGridIfPossible);
     }
     return d->load();
 }
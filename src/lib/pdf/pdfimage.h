@@ -101,6 +101,7 @@ public:
         NoHint = 0, ///< Load image data as-is. The default.
         AbortOnColorHint = 1, ///< Abort loading when encountering a non black/white pixel, as a shortcut for barcode detection.
         ConvertToGrayscaleHint = 2, ///< Convert to QImage::Format_Grayscale8 during loading. More efficient than converting later if all you need is grayscale.
+        RenderVectorPathsHint = 4, ///< Render vector images by painting their paths, rather than from a reconstructed barcode module grid. @since 26.12
     };
     Q_DECLARE_FLAGS(LoadingHints, LoadingHint)
 
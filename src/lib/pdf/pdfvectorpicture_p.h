@@ -43,7 +43,12 @@ public:
 
     QRectF boundingRect() const;
     int pathElementsCount() const;
-    QImage renderToImage() const;
+
+    enum RenderMode {
+        ModuleGridIfPossible, // render from the reconstructed module grid if this is a grid of rectangles
+        PaintPaths, // always paint the paths, e.g. when the module grid is misleading
+    };
+    QImage renderToImage(RenderMode mode = ModuleGridIfPossible) const;
 
     // size of the rendered image
     int sourceWidth() const;
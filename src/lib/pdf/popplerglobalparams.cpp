@@ -12,23 +12,33 @@
 #include <GlobalParams.h>
 
 #include <memory>
+#include <mutex>
 
 using namespace KItinerary;
 
+// while at least one instance is alive (on any thread), our parameters are installed
+// as poppler's globalParams and this holds the previous ones, otherwise it holds ours
 static std::unique_ptr<GlobalParams> s_globalParams;
+static std::mutex s_mutex;
+static int s_refCount = 0;
 
 PopplerGlobalParams::PopplerGlobalParams()
 {
+    std::lock_guard lock(s_mutex);
+    if (s_refCount++ > 0) {
+        return;
+    }
     if (!s_globalParams) {
         s_globalParams = std::make_unique<GlobalParams>();
     }
-
-    std::swap(globalParams, m_prev);
     std::swap(s_globalParams, globalParams);
 }
 
 PopplerGlobalParams::~PopplerGlobalParams()
 {
+    std::lock_guard lock(s_mutex);
+    if (--s_refCount > 0) {
+        return;
+    }
     std::swap(s_globalParams, globalParams);
-    std::swap(globalParams, m_prev);
 }
@@ -6,21 +6,18 @@
 
 #pragma once
 
-#include <memory>
-
-class GlobalParams;
-
 namespace KItinerary {
 
-/** RAII wrapper of the globalParams object. */
+/** RAII wrapper of the globalParams object.
+ *  Instances can be nested and used concurrently from multiple threads.
+ */
 class PopplerGlobalParams
 {
 public:
     PopplerGlobalParams();
     ~PopplerGlobalParams();
-
-private:
-    std::unique_ptr<GlobalParams> m_prev;
+    PopplerGlobalParams(const PopplerGlobalParams&) = delete;
+    PopplerGlobalParams& operator=(const PopplerGlobalParams&) = delete;
 };
 
 }
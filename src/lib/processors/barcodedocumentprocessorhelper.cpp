@@ -4,11 +4,17 @@
 */
 
 #include "barcodedocumentprocessorhelper.h"
+#include "barcodelocator_p.h"
 
 #include <KItinerary/ExtractorDocumentNode>
 #include <KItinerary/ExtractorDocumentNodeFactory>
 #include <KItinerary/ExtractorEngine>
 
+#include <QImage>
+
+#include <algorithm>
+#include <iterator>
+
 using namespace KItinerary;
 
 static bool appendBarcodeResult(const BarcodeDecoder::Result &result, ExtractorDocumentNode &parent, const ExtractorEngine *engine)
@@ -44,15 +50,46 @@ static bool appendBarcodeResult(const BarcodeDecoder::Result &result, ExtractorD
     return true;
 }
 
+static bool appendBarcodeResults(const std::vector<BarcodeDecoder::Result> &results, ExtractorDocumentNode &parent, const ExtractorEngine *engine)
+{
+    bool found = false;
+    for (const auto &res : results) {
+        found = appendBarcodeResult(res, parent, engine) || found; // no short-circuit evaluation!
+    }
+    return found;
+}
+
 bool BarcodeDocumentProcessorHelper::expandNode(const QImage &img, BarcodeDecoder::BarcodeTypes barcodeHints, ExtractorDocumentNode &parent, const ExtractorEngine* engine)
 {
+    if ((barcodeHints & BarcodeDecoder::Any) == BarcodeDecoder::None || img.isNull()
+        || !engine->consumePixelBudget((qint64)img.width() * img.height())) {
+        return false;
+    }
+
     if (barcodeHints & BarcodeDecoder::IgnoreAspectRatio) {
-        const auto results = engine->barcodeDecoder()->decodeMulti(img, barcodeHints);
-        bool found = false;
-        for (const auto &res : results) {
-            found = appendBarcodeResult(res, parent, engine) || found; // no short-circuit evaluation!
+        // for large images such as full page rasters, look at areas likely containing a barcode first
+        // and only skip searching the entire image if those provably contain all barcodes
+        std::vector<BarcodeDecoder::Result> results;
+        if (std::max(img.width(), img.height()) >= BarcodeLocator::MinImageSize) {
+            bool isComplete = false;
+            const auto regions = BarcodeLocator::findCandidateRegions(img, &isComplete);
+            for (const auto &region : regions) {
+                auto regionResults = engine->barcodeDecoder()->decodeMulti(img, region, barcodeHints);
+                isComplete &= !regionResults.empty();
+                std::move(regionResults.begin(), regionResults.end(), std::back_inserter(results));
+            }
+            if (isComplete && !regions.empty()) {
+                return appendBarcodeResults(results, parent, engine);
+            }
+        }
+
+        // barcodes found in the candidate regions will usually be found again here
+        for (auto &res : engine->barcodeDecoder()->decodeMulti(img, barcodeHints)) {
+            if (std::none_of(results.begin(), results.end(), [&res](const auto &r) { return r.contentType == res.contentType && r.content == res.content; })) {
+                results.push_back(std::move(res));
+            }
         }
-        return found;
+        return appendBarcodeResults(results, parent, engine);
     } else {
         return appendBarcodeResult(engine->barcodeDecoder()->decode(img, barcodeHints), parent, engine);
     }
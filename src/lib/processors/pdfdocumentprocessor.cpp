@@ -17,10 +17,14 @@
 #include <KItinerary/ExtractorEngine>
 #include <KItinerary/ExtractorResult>
 #include <KItinerary/PdfDocument>
+#include <KItinerary/PdfImage>
 
 #include <QImage>
 #include <QJSEngine>
+#include <QSet>
 
+#include <algorithm>
+#include <unordered_set>
 
 using namespace KItinerary;
 
@@ -95,18 +99,35 @@ ExtractorDocumentNode PdfDocumentProcessor::createNodeFromContent(const QVariant
     return node;
 }
 
+// content of the barcodes decoded from image node @p node, if any
+static QList<QByteArray> barcodePayloads(const ExtractorDocumentNode &node)
+{
+    QList<QByteArray> payloads;
+    for (const auto &child : node.childNodes()) {
+        if (child.isA<QByteArray>()) {
+            payloads.push_back(child.content<QByteArray>());
+        } else if (child.isA<QString>()) {
+            payloads.push_back(child.content<QString>().toUtf8());
+        }
+    }
+    return payloads;
+}
+
 void PdfDocumentProcessor::expandNode(ExtractorDocumentNode &node, const ExtractorEngine *engine) const
 {
     const auto doc = node.content<PdfDocument*>();
 
-    for (int i = 0; i < doc->pageCount(); ++i) {
+    // processors are shared between all engines, so this must not be a member
+    std::unordered_set<PdfImageRef> imageIds;
+    for (int i = 0; i < doc->pageCount() && engine->checkTimeBudget(); ++i) {
         const auto page = doc->page(i);
-        m_imageIds.clear();
+        imageIds.clear();
+        QSet<QByteArray> seenPayloads;
 
-        for (int j = 0; j < page.imageCount(); ++j) {
+        for (int j = 0; j < page.imageCount() && engine->checkTimeBudget(); ++j) {
             auto img = page.image(j);
             img.setLoadingHints(PdfImage::AbortOnColorHint | PdfImage::ConvertToGrayscaleHint); // we only care about b/w-ish images for barcode detection
-            if (img.hasObjectId() &&  m_imageIds.find(img.objectId()) != m_imageIds.end()) {
+            if (img.hasObjectId() &&  imageIds.find(img.objectId()) != imageIds.end()) {
                 continue;
             }
 
@@ -122,21 +143,40 @@ void PdfDocumentProcessor::expandNode(ExtractorDocumentNode &node, const Extract
 
             auto childNode = engine->documentNodeFactory()->createNode(imgData, u"internal/qimage");
             childNode.setLocation(i);
-            node.appendChild(childNode); // TODO the old code de-duplicated repeated barcodes here - do we actually need that?
             if (img.hasObjectId()) {
-                m_imageIds.insert(img.objectId());
+                imageIds.insert(img.objectId());
             }
 
             // technically not our job to do this here rather than letting the image node processor handle this
             // but we have the output aspect ratio of the barcode only here, which gives better decoding hints
-            if (BarcodeDocumentProcessorHelper::expandNode(imgData, barcodeHints, childNode, engine)) {
-                continue;
+            // if this fails, check if the image as a aspect-ratio distorting scale and try again with that
+            if (!BarcodeDocumentProcessorHelper::expandNode(imgData, barcodeHints, childNode, engine)) {
+                if (img.hasAspectRatioTransform()) {
+                    BarcodeDocumentProcessorHelper::expandNode(img.applyAspectRatioTransform(imgData), barcodeHints, childNode, engine);
+                } else if (img.isVectorImage()) {
+                    // vector barcodes are rendered from their module grid where possible, should that be
+                    // misleading try again with the paths painted as-is
+                    img.setLoadingHints(PdfImage::AbortOnColorHint | PdfImage::ConvertToGrayscaleHint | PdfImage::RenderVectorPathsHint);
+                    const auto pathImgData = img.image();
+                    if (!pathImgData.isNull() && pathImgData.cacheKey() != imgData.cacheKey()) {
+                        BarcodeDocumentProcessorHelper::expandNode(pathImgData, barcodeHints, childNode, engine);
+                    }
+                }
             }
 
-            // if this failed, check if the image as a aspect-ratio distorting scale and try again with that
-            if (img.hasAspectRatioTransform()) {
-                BarcodeDocumentProcessorHelper::expandNode(img.applyAspectRatioTransform(imgData), barcodeHints, childNode, engine);
+            // the same barcode can be present multiple times on a page (e.g. in different sizes or as separate
+            // image objects), extracting that more than once would just produce duplicate results
+            // barcodes repeated on other pages are kept, as scripts rely on the page location of their trigger node
+            const auto payloads = barcodePayloads(childNode);
+            if (!payloads.isEmpty()) {
+                if (std::all_of(payloads.begin(), payloads.end(), [&seenPayloads](const auto &payload) { return seenPayloads.contains(payload); })) {
+                    continue;
+                }
+                for (const auto &payload : payloads) {
+                    seenPayloads.insert(payload);
+                }
             }
+            node.appendChild(childNode);
         }
 
         // handle full page raster images (ignoring masks)
@@ -149,7 +189,7 @@ void PdfDocumentProcessor::expandNode(ExtractorDocumentNode &node, const Extract
         if ((engine->hints() & ExtractorEngine::ExtractFullPageRasterImages) && imageCount == 1 && page.text().isEmpty()) {
             qDebug() << "full page raster image";
             auto img = page.image(0);
-            if (img.hasObjectId() &&  m_imageIds.find(img.objectId()) != m_imageIds.end()) { // already handled
+            if (img.hasObjectId() &&  imageIds.find(img.objectId()) != imageIds.end()) { // already handled
                 continue;
             }
 
@@ -163,7 +203,7 @@ void PdfDocumentProcessor::expandNode(ExtractorDocumentNode &node, const Extract
             childNode.setLocation(i);
             node.appendChild(childNode);
             if (img.hasObjectId()) {
-                m_imageIds.insert(img.objectId());
+                imageIds.insert(img.objectId());
             }
         }
     }
@@ -7,9 +7,6 @@
 #pragma once
 
 #include <KItinerary/ExtractorDocumentProcessor>
-#include <KItinerary/PdfImage>
-
-#include <unordered_set>
 
 namespace KItinerary {
 
@@ -27,9 +24,6 @@ public:
     void postExtract(ExtractorDocumentNode &node, const ExtractorEngine *engine) const override;
     QJSValue contentToScriptValue(const ExtractorDocumentNode &node, QJSEngine *engine) const override;
     void destroyNode(ExtractorDocumentNode &node) const override;
-
-private:
-    mutable std::unordered_set<PdfImageRef> m_imageIds;
 };
 
 }
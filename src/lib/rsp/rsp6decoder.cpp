@@ -14,9 +14,14 @@
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QMutex>
 
 #include <openssl/err.h>
 
+#include <atomic>
+#include <string>
+#include <unordered_map>
+
 using namespace KItinerary;
 
 static QByteArray decodeBase26Backward(const char *begin, const char *end)
@@ -81,6 +86,60 @@ static std::vector<openssl::evp_pkey_ptr> loadKeys(std::string_view keyId)
     return keys;
 }
 
+namespace {
+enum class Rsp6Padding : uint8_t {
+    PKCS1Type1,
+    PKCS1Type2,
+};
+
+struct Rsp6IssuerKeys {
+    std::vector<openssl::evp_pkey_ptr> keys;
+    // key and padding scheme that worked last for this issuer, tried first next time
+    std::atomic<std::size_t> preferredKey = 0;
+    std::atomic<Rsp6Padding> preferredPadding = Rsp6Padding::PKCS1Type1;
+};
+
+/** Process-wide cache of the parsed RSA keys per issuer. */
+struct Rsp6KeyCache {
+    QMutex mutex;
+    std::unordered_map<std::string, std::unique_ptr<Rsp6IssuerKeys>> issuers;
+};
+}
+
+Q_GLOBAL_STATIC(Rsp6KeyCache, s_keyCache)
+
+/** Returns the keys for @p keyId, or @c nullptr if there are none.
+ *  The returned object remains valid for the lifetime of the process.
+ */
+[[nodiscard]] static Rsp6IssuerKeys* issuerKeys(std::string_view keyId)
+{
+    auto cache = s_keyCache();
+    QMutexLocker lock(&cache->mutex);
+    const auto it = cache->issuers.find(std::string(keyId));
+    if (it != cache->issuers.end()) {
+        return it->second.get();
+    }
+
+    auto keys = loadKeys(keyId);
+    if (keys.empty()) {
+        return nullptr;
+    }
+    auto entry = std::make_unique<Rsp6IssuerKeys>();
+    entry->keys = std::move(keys);
+    return cache->issuers.emplace(std::string(keyId), std::move(entry)).first->second.get();
+}
+
+[[nodiscard]] static int removePadding(Rsp6Padding padding, QByteArray &depadded, const QByteArray &decrypted, int keySize)
+{
+    switch (padding) {
+        case Rsp6Padding::PKCS1Type1:
+            return RSA_padding_check_PKCS1_type_1((uint8_t*)depadded.data(), depadded.size(), (const uint8_t*)decrypted.data(), decrypted.size(), keySize);
+        case Rsp6Padding::PKCS1Type2:
+            return RSA_padding_check_PKCS1_type_2((uint8_t*)depadded.data(), depadded.size(), (const uint8_t*)decrypted.data(), decrypted.size(), keySize);
+    }
+    return -1;
+}
+
 QByteArray Rsp6Decoder::decode(const QByteArray &data)
 {
     // verify version signature and sufficient size
@@ -89,8 +148,8 @@ QByteArray Rsp6Decoder::decode(const QByteArray &data)
     }
 
     // load RSA key
-    const auto keys = loadKeys(std::string_view(data.data() + 13, 2));
-    if (keys.empty()) {
+    const auto keys = issuerKeys(std::string_view(data.data() + 13, 2));
+    if (!keys) {
         qWarning() << "no RSP-6 key found for issuer:" << QByteArray(data.data() + 13 , 2);
         return {};
     }
@@ -99,9 +158,17 @@ QByteArray Rsp6Decoder::decode(const QByteArray &data)
     const auto decoded = decodeBase26Backward(data.begin() + 15, data.end());
 
     // decrypt payload, try all keys for the current issuer until we find one that works
+    // starting with the one that worked last time
+    const auto keyCount = keys->keys.size();
+    const auto preferredKey = keys->preferredKey.load(std::memory_order_relaxed);
+    const auto preferredPadding = keys->preferredPadding.load(std::memory_order_relaxed);
+    const auto otherPadding = preferredPadding == Rsp6Padding::PKCS1Type1 ? Rsp6Padding::PKCS1Type2 : Rsp6Padding::PKCS1Type1;
+
     QByteArray decrypted;
     QByteArray depadded;
-    for (const auto &key : keys) {
+    for (std::size_t i = 0; i < keyCount; ++i) {
+        const auto keyIdx = (preferredKey + i) % keyCount;
+        const auto &key = keys->keys[keyIdx];
         openssl::evp_pkey_ctx_ptr ctx(EVP_PKEY_CTX_new(key.get(), nullptr));
         EVP_PKEY_verify_recover_init(ctx.get());
         EVP_PKEY_CTX_set_rsa_padding(ctx.get(), RSA_NO_PADDING);
@@ -114,18 +181,15 @@ QByteArray Rsp6Decoder::decode(const QByteArray &data)
 
         // we don't know the padding scheme, so we have to try all of them
         depadded.resize((qsizetype)decryptedSize);
-        // PKCS#1 type 1
-        const auto rsa = openssl::rsa_ptr(EVP_PKEY_get1_RSA(key.get()));
-        auto depaddedSize = RSA_padding_check_PKCS1_type_1((uint8_t*)depadded.data(), depadded.size(), (const uint8_t*)decrypted.data(), decrypted.size(), RSA_size(rsa.get()));
-        if (depaddedSize > 0) {
-            depadded.resize(depaddedSize);
-            return depadded;
-        }
-        // PKCS#1 type 2
-        depaddedSize = RSA_padding_check_PKCS1_type_2((uint8_t*)depadded.data(), depadded.size(), (const uint8_t*)decrypted.data(), decrypted.size(), RSA_size(rsa.get()));
-        if (depaddedSize > 0) {
-            depadded.resize(depaddedSize);
-            return depadded;
+        const auto keySize = EVP_PKEY_get_size(key.get());
+        for (const auto padding : {preferredPadding, otherPadding}) {
+            const auto depaddedSize = removePadding(padding, depadded, decrypted, keySize);
+            if (depaddedSize > 0) {
+                keys->preferredKey.store(keyIdx, std::memory_order_relaxed);
+                keys->preferredPadding.store(padding, std::memory_order_relaxed);
+                depadded.resize(depaddedSize);
+                return depadded;
+            }
         }
     }
 
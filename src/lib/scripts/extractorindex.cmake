@@ -0,0 +1,79 @@
+# SPDX-FileCopyrightText: 2026 KItinerary contributors
+# SPDX-License-Identifier: BSD-3-Clause
+
+# Validates the extractor meta-data files listed in @p qrcFile and combines them
+# into a single JSON index in @p outputDir. This saves ExtractorRepository from iterating,
+# opening and parsing each meta-data file individually at runtime.
+# The generated extractors.qrc in @p outputDir contains the index and all other files
+# listed in @p qrcFile, and is what should be compiled in instead of @p qrcFile, so
+# the meta-data isn't embedded twice.
+function(kitinerary_generate_extractor_index qrcFile outputDir)
+    get_filename_component(_dir ${qrcFile} DIRECTORY)
+    file(STRINGS ${qrcFile} _entries REGEX "<file>.*</file>")
+    set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${qrcFile})
+
+    set(_index "{\n")
+    set(_separator "")
+    set(_resources "")
+    foreach(_entry ${_entries})
+        string(REGEX REPLACE ".*<file>(.*)</file>.*" "\\1" _file "${_entry}")
+        if (NOT _file MATCHES "\\.json$")
+            string(APPEND _resources "        <file alias=\"${_file}\">${_dir}/${_file}</file>\n")
+            continue()
+        endif()
+        set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${_dir}/${_file})
+        file(READ ${_dir}/${_file} _content)
+
+        string(JSON _type ERROR_VARIABLE _error TYPE "${_content}")
+        if (_error)
+            message(FATAL_ERROR "Invalid extractor meta-data in ${_file}: ${_error}")
+        endif()
+        if (_type STREQUAL "OBJECT")
+            set(_extractors "${_content}")
+            set(_count 1)
+        elseif (_type STREQUAL "ARRAY")
+            string(JSON _count LENGTH "${_content}")
+        else()
+            message(FATAL_ERROR "Invalid extractor meta-data in ${_file}: expected object or array")
+        endif()
+
+        math(EXPR _last "${_count} - 1")
+        foreach(_i RANGE ${_last})
+            if (_type STREQUAL "ARRAY")
+                string(JSON _extractor GET "${_content}" ${_i})
+            else()
+                set(_extractor "${_content}")
+            endif()
+            string(JSON _mimeType ERROR_VARIABLE _error GET "${_extractor}" mimeType)
+            if (_error)
+                message(FATAL_ERROR "Extractor ${_i} in ${_file} has no MIME type")
+            endif()
+            string(JSON _filterCount ERROR_VARIABLE _error LENGTH "${_extractor}" filter)
+            if (_error OR _filterCount EQUAL 0)
+                message(FATAL_ERROR "Extractor ${_i} in ${_file} has no filters")
+            endif()
+            string(JSON _script ERROR_VARIABLE _error GET "${_extractor}" script)
+            if (NOT _error AND NOT EXISTS ${_dir}/${_script})
+                message(FATAL_ERROR "Script ${_script} referenced in ${_file} not found")
+            endif()
+        endforeach()
+
+        string(APPEND _index "${_separator}\"${_file}\": ${_content}")
+        set(_separator ",\n")
+    endforeach()
+    string(APPEND _index "\n}\n")
+
+    # only touch the output if the content actually changed, to avoid needless rebuilds
+    file(WRITE ${outputDir}/extractor-index.json.tmp "${_index}")
+    configure_file(${outputDir}/extractor-index.json.tmp ${outputDir}/extractor-index.json COPYONLY)
+    file(WRITE ${outputDir}/extractors.qrc.tmp
+"<RCC>
+    <qresource prefix=\"/org.kde.pim/kitinerary\">
+        <file>extractor-index.json</file>
+    </qresource>
+    <qresource prefix=\"/org.kde.pim/kitinerary/extractors\">
+${_resources}    </qresource>
+</RCC>
+")
+    configure_file(${outputDir}/extractors.qrc.tmp ${outputDir}/extractors.qrc COPYONLY)
+endfunction()
@@ -11,34 +11,65 @@
 #include <QDebug>
 #include <QString>
 
+#include <array>
 #include <cstring>
 #include <cctype>
 
 using namespace Qt::Literals;
 using namespace KItinerary;
 
+static void normalizeChar(QChar c, QString &out)
+{
+    // case folding
+    const auto n = c.toCaseFolded();
+
+    // if the character has a canonical decomposition use that and skip the
+    // combining diacritic markers following it
+    // see https://en.wikipedia.org/wiki/Unicode_equivalence
+    // see https://en.wikipedia.org/wiki/Combining_character
+    if (n.decompositionTag() == QChar::Canonical) {
+        out.push_back(n.decomposition().at(0));
+    }
+    // handle compatibility compositions such as ligatures
+    // see https://en.wikipedia.org/wiki/Unicode_compatibility_characters
+    else if (n.decompositionTag() == QChar::Compat && n.isLetter() && n.script() == QChar::Script_Latin) {
+        out.append(n.decomposition());
+    }
+    else {
+        out.push_back(n);
+    }
+}
+
+// Latin-1 and Latin Extended-A cover most of the names we compare
+constexpr inline char16_t LatinTableSize = 0x180;
+
+// precomputed results of normalizeChar() for the Latin ranges,
+// 0 for characters not normalizing to exactly one character
+[[nodiscard]] static const std::array<char16_t, LatinTableSize>& latinNormalizationTable()
+{
+    static const auto table = []() {
+        std::array<char16_t, LatinTableSize> table;
+        QString out;
+        for (char16_t c = 0; c < LatinTableSize; ++c) {
+            out.clear();
+            normalizeChar(QChar(c), out);
+            table[c] = out.size() == 1 ? out.at(0).unicode() : 0;
+        }
+        return table;
+    }();
+    return table;
+}
+
 QString StringUtil::normalize(QStringView str)
 {
     QString out;
     out.reserve(str.size());
+    const auto &table = latinNormalizationTable();
     for (const auto c : str) {
-        // case folding
-        const auto n = c.toCaseFolded();
-
-        // if the character has a canonical decomposition use that and skip the
-        // combining diacritic markers following it
-        // see https://en.wikipedia.org/wiki/Unicode_equivalence
-        // see https://en.wikipedia.org/wiki/Combining_character
-        if (n.decompositionTag() == QChar::Canonical) {
-            out.push_back(n.decomposition().at(0));
-        }
-        // handle compatibility compositions such as ligatures
-        // see https://en.wikipedia.org/wiki/Unicode_compatibility_characters
-        else if (n.decompositionTag() == QChar::Compat && n.isLetter() && n.script() == QChar::Script_Latin) {
-            out.append(n.decomposition());
-        }
-        else {
-            out.push_back(n);
+        if (c.unicode() < LatinTableSize && table[c.unicode()]) {
+            out.push_back(QChar(table[c.unicode()]));
+        } else {
+            normalizeChar(c, out);
         }
     }
     return out;
@@ -193,6 +224,26 @@ QString StringUtil::transliterate(QStringView s)
     return res;
 }
 
+static QString normalizeString(const QString &s)
+{
+    return StringUtil::normalize(s);
+}
+
+QString StringUtil::normalizeMemoized(const QString &s)
+{
+    return memoized<normalizeString>(s);
+}
+
+static QString transliterateString(const QString &s)
+{
+    return StringUtil::transliterate(s);
+}
+
+QString StringUtil::transliterateMemoized(const QString &s)
+{
+    return memoized<transliterateString>(s);
+}
+
 bool StringUtil::startsWithIgnoreSpace(const QByteArray &data, const char *pattern)
 {
     auto it = data.begin();
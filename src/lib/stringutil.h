@@ -6,9 +6,10 @@
 
 #pragma once
 
+#include <QHash>
+#include <QString>
+
 class QByteArray;
-class QString;
-class QStringView;
 
 namespace KItinerary {
 
@@ -44,6 +45,31 @@ namespace StringUtil
 
     /** Strip leading zeros from a textual numeric value. */
     [[nodiscard]] QString stripLeadingZeros(const QString &s);
+
+    /** Returns @p Func applied to @p s, taken from a small cache of recent results if possible.
+     *  This is meant for normalizing the same few names (stations, airports, passengers) over and over
+     *  again during post-processing or calendar matching. The cache is per thread and thus needs no locking.
+     */
+    template <auto Func>
+    [[nodiscard]] inline auto memoized(const QString &s) -> decltype(Func(s))
+    {
+        using T = decltype(Func(s));
+        thread_local QHash<QString, T> s_cache;
+        if (const auto it = s_cache.constFind(s); it != s_cache.constEnd()) {
+            return it.value();
+        }
+        if (s_cache.size() >= 512) {
+            s_cache.clear();
+        }
+        auto result = Func(s);
+        s_cache.insert(s, result);
+        return result;
+    }
+
+    /** Same as normalize(), memoized. */
+    [[nodiscard]] QString normalizeMemoized(const QString &s);
+    /** Same as transliterate(), memoized. */
+    [[nodiscard]] QString transliterateMemoized(const QString &s);
 }
 
 }
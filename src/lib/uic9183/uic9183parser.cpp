@@ -31,6 +31,7 @@
 
 #include <cassert>
 #include <cstring>
+#include <vector>
 
 using namespace Qt::Literals;
 using namespace KItinerary;
@@ -40,11 +41,31 @@ namespace KItinerary {
 class Uic9183ParserPrivate : public QSharedData
 {
 public:
+    void indexBlocks();
+
     QByteArray m_data;
     QByteArray m_payload;
+    /** Offsets of all blocks in m_payload, in order. */
+    std::vector<int> m_blockOffsets;
 };
 }
 
+// upper limit for the decompressed payload, anything beyond that is not a legitimate ticket
+constexpr inline qsizetype MaxPayloadSize = 1 << 16;
+
+void Uic9183ParserPrivate::indexBlocks()
+{
+    m_blockOffsets.clear();
+    for (int offset = 0;;) {
+        const Uic9183Block block(m_payload, offset);
+        if (block.isNull()) {
+            break;
+        }
+        m_blockOffsets.push_back(offset);
+        offset += block.size();
+    }
+}
+
 Uic9183Parser::Uic9183Parser()
     : d(new Uic9183ParserPrivate)
 {
@@ -61,9 +82,9 @@ Uic9183Block Uic9183Parser::firstBlock() const
 
 Uic9183Block Uic9183Parser::findBlock(const char name[6]) const
 {
-    for (auto block = firstBlock(); !block.isNull(); block = block.nextBlock()) {
-        if (block.isA(name)) {
-            return block;
+    for (const auto offset : d->m_blockOffsets) {
+        if (std::strncmp(d->m_payload.constData() + offset, name, 6) == 0) {
+            return Uic9183Block(d->m_payload, offset);
         }
     }
     return {};
@@ -102,6 +123,7 @@ void Uic9183Parser::parse(const QByteArray &data)
 {
     d->m_data.clear();
     d->m_payload.clear();
+    d->m_blockOffsets.clear();
 
     Uic9183Header header(data);
     if (!header.isValid()) {
@@ -121,18 +143,27 @@ void Uic9183Parser::parse(const QByteArray &data)
     stream.next_out = reinterpret_cast<unsigned char*>(d->m_payload.data());
 
     inflateInit(&stream);
-    const auto res = inflate(&stream, Z_NO_FLUSH);
-    switch (res) {
-        case Z_OK:
-        case Z_STREAM_END:
-            break; // all good
-        default:
+    for (;;) {
+        const auto res = inflate(&stream, Z_NO_FLUSH);
+        if (res == Z_STREAM_END || (res == Z_BUF_ERROR && stream.total_out > 0)) {
+            break;
+        }
+        if (res != Z_OK) {
             qCWarning(Log) << "UIC 918.3 payload zlib decompression failed" << stream.msg;
+            inflateEnd(&stream);
+            d->m_payload.clear();
             return;
+        }
+        // input exhausted, or output buffer full and we have to grow it
+        if (stream.avail_out > 0 || d->m_payload.size() >= MaxPayloadSize) {
+            break;
+        }
+        d->m_payload.resize(std::min(d->m_payload.size() * 2, MaxPayloadSize));
+        stream.avail_out = d->m_payload.size() - stream.total_out;
+        stream.next_out = reinterpret_cast<unsigned char*>(d->m_payload.data() + stream.total_out);
     }
     inflateEnd(&stream);
-    d->m_payload.truncate(d->m_payload.size() - stream.avail_out);
-    //qCDebug(Log) << res <<  d->m_payload << stream.avail_out;
+    d->m_payload.truncate(stream.total_out);
 
     // workaround for Renfe (1071) having various errors...
     if (d->m_payload.size() > 600 && d->m_payload.startsWith("U_HEAD0100531071") && d->m_payload[54] == 'U' && d->m_payload[36] == ' ') {
@@ -146,6 +177,8 @@ void Uic9183Parser::parse(const QByteArray &data)
             qCDebug(Log) << d->m_payload;
         }
     }
+
+    d->indexBlocks();
 }
 
 bool Uic9183Parser::isValid() const
@@ -12,8 +12,12 @@
 
 #include <QDate>
 #include <QDebug>
+#include <QDirIterator>
 #include <QFile>
+#include <QHash>
+#include <QMutex>
 
+using namespace Qt::Literals::StringLiterals;
 using namespace KItinerary;
 
 VdvCertificate::VdvCertificate() = default;
@@ -176,17 +180,25 @@ const VdvCertificateKey* VdvCertificate::certKey() const
 }
 
 
-VdvCertificate VdvPkiRepository::caCertificate(const VdvCaReference *car)
+namespace {
+/** Process-wide cache of validated (sub)CA certificates, keyed by their raw CA reference. */
+struct VdvCaCertificateCache {
+    QMutex mutex;
+    QHash<QByteArray, VdvCertificate> certs;
+};
+}
+
+Q_GLOBAL_STATIC(VdvCaCertificateCache, s_caCertCache)
+
+constexpr inline auto CaCertificatePath = ":/org.kde.pim/kitinerary/vdv/certs/"_L1;
+constexpr inline auto CaCertificateSuffix = ".vdv-cert"_L1;
+
+[[nodiscard]] static VdvCertificate loadCaCertificate(const QByteArray &carKey)
 {
-  QFile f(QLatin1StringView(":/org.kde.pim/kitinerary/vdv/certs/") +
-          QString::fromLatin1(QByteArray(reinterpret_cast<const char *>(car),
-                                         sizeof(VdvCaReference))
-                                  .toHex()) +
-          QLatin1StringView(".vdv-cert"));
-  if (!f.open(QFile::ReadOnly)) {
-    qWarning() << "Failed to open CA cert file" << f.fileName()
-               << f.errorString();
-    return VdvCertificate();
+    QFile f(CaCertificatePath + QString::fromLatin1(carKey.toHex()) + CaCertificateSuffix);
+    if (!f.open(QFile::ReadOnly)) {
+        qWarning() << "Failed to open CA cert file" << f.fileName() << f.errorString();
+        return VdvCertificate();
     }
 
     VdvCertificate cert(f.readAll());
@@ -198,7 +210,42 @@ VdvCertificate VdvPkiRepository::caCertificate(const VdvCaReference *car)
         rootCAR.discretionaryData = 1;
         rootCAR.algorithmReference = 1;
         rootCAR.year = 6;
-        cert.setCaCertificate(caCertificate(&rootCAR));
+        cert.setCaCertificate(VdvPkiRepository::caCertificate(&rootCAR));
     }
     return cert;
 }
+
+VdvCertificate VdvPkiRepository::caCertificate(const VdvCaReference *car)
+{
+    const QByteArray carKey(reinterpret_cast<const char*>(car), sizeof(VdvCaReference));
+    auto cache = s_caCertCache();
+    {
+        QMutexLocker lock(&cache->mutex);
+        const auto it = cache->certs.constFind(carKey);
+        if (it != cache->certs.constEnd()) {
+            return it.value();
+        }
+    }
+
+    // loading happens unlocked, as this recurses for the root certificate
+    // concurrent loads of the same certificate are harmless, they produce identical results
+    const auto cert = loadCaCertificate(carKey);
+    if (cert.isValid()) {
+        QMutexLocker lock(&cache->mutex);
+        cache->certs.insert(carKey, cert);
+    }
+    return cert;
+}
+
+void VdvPkiRepository::preloadCaCertificates()
+{
+    QDirIterator it(CaCertificatePath, {u"*"_s + CaCertificateSuffix}, QDir::Files);
+    while (it.hasNext()) {
+        it.next();
+        const auto carKey = QByteArray::fromHex(it.fileInfo().baseName().toLatin1());
+        if (carKey.size() != sizeof(VdvCaReference)) {
+            continue;
+        }
+        caCertificate(reinterpret_cast<const VdvCaReference*>(carKey.constData()));
+    }
+}
@@ -74,8 +74,13 @@ private:
 /** VDV (sub)CA certificate access. */
 namespace VdvPkiRepository
 {
-    /** Returns the (sub)CA certificate for the given CA Reference (CAR). */
+    /** Returns the (sub)CA certificate for the given CA Reference (CAR).
+     *  Successfully decoded certificates are cached for the lifetime of the process.
+     */
     VdvCertificate caCertificate(const VdvCaReference *car);
+
+    /** Decodes all known (sub)CA certificates ahead of time. */
+    void preloadCaCertificates();
 }
 
 }
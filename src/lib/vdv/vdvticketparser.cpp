@@ -102,3 +102,8 @@ VdvTicket VdvTicketParser::ticket() const
 {
     return m_ticket;
 }
+
+void VdvTicketParser::preloadCertificates()
+{
+    VdvPkiRepository::preloadCaCertificates();
+}
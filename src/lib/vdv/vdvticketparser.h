@@ -45,6 +45,14 @@ public:
      */
     static bool maybeVdvTicket(const QByteArray &data);
 
+    /** Decode and cache all known CA certificates.
+     *  This happens on demand otherwise, calling this is only useful
+     *  for long-running processes that want to avoid that cost on the
+     *  first tickets they see.
+     *  @since 26.12
+     */
+    static void preloadCertificates();
+
 private:
     VdvTicket m_ticket;
 };
@@ -14,7 +14,11 @@
 #include <QCoreApplication>
 #include <QDebug>
 #include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 
+#include <iomanip>
 #include <iostream>
 
 using namespace KItinerary;
@@ -42,6 +46,17 @@ static void printNode(const ExtractorDocumentNode &node, int indent = 0)
     }
 }
 
+static void printStatistics(const std::vector<ExtractorEngine::StatisticsEntry> &stats)
+{
+    std::cout << std::endl << "time [ms]  count   hits  step           name" << std::endl;
+    for (const auto &entry : stats) {
+        std::cout << std::setw(9) << std::fixed << std::setprecision(2) << (entry.time.count() / 1000000.0)
+                  << std::setw(7) << entry.count << std::setw(7) << entry.hits
+                  << "  " << std::left << std::setw(15) << qPrintable(entry.step) << std::right
+                  << qPrintable(entry.name) << std::endl;
+    }
+}
+
 int main(int argc, char **argv)
 {
     QCoreApplication::setApplicationName(QStringLiteral("extractor-document-dump"));
@@ -54,6 +69,10 @@ int main(int argc, char **argv)
     parser.setApplicationDescription(QStringLiteral("Dump extractor document node tree."));
     parser.addHelpOption();
     parser.addVersionOption();
+    QCommandLineOption statsOpt({QStringLiteral("stats")}, QStringLiteral("Print timing statistics for all processing steps."));
+    parser.addOption(statsOpt);
+    QCommandLineOption traceOpt({QStringLiteral("trace")}, QStringLiteral("Write a timeline of all processing steps in Chrome trace event format to the given file."), QStringLiteral("file"));
+    parser.addOption(traceOpt);
     parser.addPositionalArgument(QStringLiteral("input"), QStringLiteral("File to read data from, omit for using stdin."));
     parser.process(app);
 
@@ -70,9 +89,25 @@ int main(int argc, char **argv)
     const auto data = file.readAll();
 
     ExtractorEngine engine;
+    engine.setCollectStatistics(parser.isSet(statsOpt));
+    engine.setRecordTrace(parser.isSet(traceOpt));
     engine.setData(data, file.fileName());
     engine.extract();
     printNode(engine.rootDocumentNode());
+    if (parser.isSet(statsOpt)) {
+        printStatistics(engine.statistics());
+    }
+    if (parser.isSet(traceOpt)) {
+        QFile traceFile(parser.value(traceOpt));
+        if (!traceFile.open(QFile::WriteOnly | QFile::Truncate)) {
+            std::cerr << qPrintable(traceFile.errorString()) << std::endl;
+            return 1;
+        }
+        QJsonObject trace;
+        trace.insert(QLatin1StringView("traceEvents"), engine.traceEvents());
+        trace.insert(QLatin1StringView("displayTimeUnit"), QLatin1StringView("ms"));
+        traceFile.write(QJsonDocument(trace).toJson(QJsonDocument::Compact));
+    }
 
     return 0;
 }